@@ -1,9 +1,17 @@
 #version 460
 
+layout(constant_id = 0) const bool encodeSrgb = false;
+
 layout(location = 0) in vec3 fragColor;
 
 layout(location = 0) out vec4 outColor;
 
+vec3 linearToSrgb(vec3 color) {
+    vec3 low = color * 12.92;
+    vec3 high = 1.055 * pow(color, vec3(1.0 / 2.4)) - 0.055;
+    return mix(high, low, lessThanEqual(color, vec3(0.0031308)));
+}
+
 void main() {
-    outColor = vec4(fragColor, 1.0);
+    outColor = vec4(encodeSrgb ? linearToSrgb(fragColor) : fragColor, 1.0);
 }
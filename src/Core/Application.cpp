@@ -1,21 +1,54 @@
 #include "Application.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string_view>
+
+#include <spdlog/fmt/fmt.h>
+
+#include "Profiler.hpp"
+#include "Benchmark.hpp"
+
 namespace Renderer {
 
-    Application::Application()
+    Application::Application(const Config& config)
+        : m_Config(config)
     {
         s_Instance = this;
 
         m_EventQueue = CreateScope<EventQueue>();
 
-        m_Window = CreateRef<Window>(Window::Config{
-            .width = 1280,
-            .height = 720,
-            .title = "Renderer"
-        });
-        m_Window->BindEventQueue(m_EventQueue.get());
+        if (m_Config.headless) {
+            m_Renderer = CreateScope<Renderer>(Renderer::HeadlessConfig {
+                .extent = { m_Config.width, m_Config.height },
+                .context = { .deviceOverride = m_Config.device },
+                .shaderObjects = m_Config.shaderObjects,
+                .schedule = m_Config.schedule,
+                .graphDumpPath = m_Config.graphDumpPath
+            });
+        } else {
+            m_Window = CreateRef<Window>(Window::Config{
+                .width = m_Config.width,
+                .height = m_Config.height,
+                .title = "Renderer"
+            });
+            m_Window->BindEventQueue(m_EventQueue.get());
+
+            m_Renderer = CreateScope<Renderer>(m_Window, Renderer::Config {
+                .pacing = { .enabled = m_Config.lowLatency },
+                .context = { .deviceOverride = m_Config.device },
+                .shaderObjects = m_Config.shaderObjects,
+                .schedule = m_Config.schedule,
+                .graphDumpPath = m_Config.graphDumpPath
+            });
+        }
+
+        if (m_Config.capture.frameCount != 0)
+            m_Renderer->RequestCapture(m_Config.capture);
 
-        m_Renderer = CreateScope<Renderer>(m_Window);
+        if (m_Config.dynamicResolution.enabled)
+            m_Renderer->SetDynamicResolution(m_Config.dynamicResolution);
     }
 
     Application::~Application()
@@ -23,21 +56,242 @@ namespace Renderer {
         s_Instance = nullptr;
     }
 
+    Application::Config Application::ParseCommandLine(i32 argc, char** argv)
+    {
+        Config config {};
+
+        for (i32 i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--headless") {
+                config.headless = true;
+            } else if (arg == "--frames" && hasValue) {
+                config.frameCount = std::strtoull(argv[++i], nullptr, 10);
+            } else if (arg == "--width" && hasValue) {
+                config.width = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg == "--height" && hasValue) {
+                config.height = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg == "--device" && hasValue) {
+                config.device = argv[++i];
+            } else if (arg == "--low-latency") {
+                config.lowLatency = true;
+            } else if (arg == "--no-shader-objects") {
+                config.shaderObjects = false;
+            } else if (arg == "--schedule" && hasValue) {
+                std::string_view schedule = argv[++i];
+                if (schedule == "naive") {
+                    config.schedule = ScheduleMode::Naive;
+                } else if (schedule == "optimized") {
+                    config.schedule = ScheduleMode::Optimized;
+                } else {
+                    LOG_WARN("Unknown schedule {}, using naive", schedule)
+                }
+            } else if (arg == "--dynamic-resolution") {
+                config.dynamicResolution.enabled = true;
+            } else if (arg == "--target-gpu-ms" && hasValue) {
+                config.dynamicResolution.targetGpuMs = std::strtod(argv[++i], nullptr);
+            } else if (arg == "--min-render-scale" && hasValue) {
+                config.dynamicResolution.minScale = std::strtof(argv[++i], nullptr);
+            } else if (arg == "--benchmark") {
+                config.benchmark = true;
+            } else if (arg == "--warmup" && hasValue) {
+                config.warmupFrames = std::strtoull(argv[++i], nullptr, 10);
+            } else if (arg == "--benchmark-out" && hasValue) {
+                config.benchmarkOutput = argv[++i];
+            } else if (arg == "--profile" && hasValue) {
+                config.profileOutput = argv[++i];
+            } else if (arg == "--dump-graph" && hasValue) {
+                config.graphDumpPath = argv[++i];
+            } else if (arg == "--capture" && hasValue) {
+                config.capture.frameCount = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg == "--capture-dir" && hasValue) {
+                config.capture.outputDirectory = argv[++i];
+            } else if (arg == "--capture-format" && hasValue) {
+                std::string_view format = argv[++i];
+                if (format == "png") {
+                    config.capture.fileFormat = VulkanFrameCapture::FileFormat::Png;
+                } else if (format == "raw") {
+                    config.capture.fileFormat = VulkanFrameCapture::FileFormat::Raw;
+                } else {
+                    LOG_WARN("Unknown capture format {}, using png", format)
+                }
+            } else {
+                LOG_WARN("Ignoring unknown argument {}", arg)
+            }
+        }
+
+        if ((config.headless || config.benchmark) && config.frameCount == 0) {
+            LOG_WARN("No --frames given, rendering 1000 frames")
+            config.frameCount = 1000;
+        }
+
+        if (!config.benchmark)
+            config.warmupFrames = 0;
+
+#if defined(NDEBUG) && !defined(RENDERER_ENABLE_PROFILING)
+        // Printed because warnings are compiled out of the same builds.
+        if (!config.profileOutput.empty()) {
+            fmt::print(stderr, "Ignoring --profile {}: profiling is compiled out, configure with -DRENDERER_ENABLE_PROFILING=ON\n", config.profileOutput);
+            config.profileOutput.clear();
+        }
+#endif
+
+        return config;
+    }
+
     void Application::Run()
     {
+        PROFILE_THREAD("Main")
+
+        // Warm-up frames run first and are excluded from timing, so that
+        // pipeline creation and driver ramp-up do not skew the results.
+        u64 totalFrames = m_Config.frameCount != 0 ? m_Config.warmupFrames + m_Config.frameCount : 0;
+
+        std::vector<f64> cpuFrameMs;
+        if (m_Config.benchmark) {
+            cpuFrameMs.reserve(m_Config.frameCount);
+            m_Renderer->SetFrameStatsEnabled(true);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        u64 submittedFrames = 0;
+
         while (m_Running) {
-            Window::PollEvents();
-            ProcessEvents();
+            PROFILE_SCOPE("Application::Frame")
+
+            auto frameStart = std::chrono::steady_clock::now();
+
+            if (m_Window) {
+                Window::PollEvents();
+                ProcessEvents();
+            }
 
             if (!m_Minimized) {
-                std::vector<Renderer::RenderPacket> renderPackets(1, {});
+                std::vector<Renderer::RenderPacket> renderPackets(1, Renderer::RenderPacket {
+                    .inputTimestampNs = Profiler::Now()
+                });
                 m_Renderer->Submit(renderPackets);
+                submittedFrames++;
+
+                // In low-latency mode the renderer holds each frame until the
+                // pacer releases it, which delays sampling the next input.
+                if (m_Config.lowLatency && totalFrames == 0)
+                    m_Renderer->WaitForFrame(submittedFrames);
+
+                // A fixed-length run waits for each frame so that no submission
+                // is coalesced away and the frame count is exact.
+                if (totalFrames != 0) {
+                    m_Renderer->WaitForFrame(submittedFrames);
+
+                    if (submittedFrames == m_Config.warmupFrames)
+                        start = std::chrono::steady_clock::now();
+
+                    if (submittedFrames >= totalFrames)
+                        m_Running = false;
+                }
+
+                if (m_Config.benchmark && submittedFrames > m_Config.warmupFrames) {
+                    std::chrono::duration<f64, std::milli> frameTime = std::chrono::steady_clock::now() - frameStart;
+                    cpuFrameMs.push_back(frameTime.count());
+                }
             }
         }
+
+        if (totalFrames != 0) {
+            std::chrono::duration<f64> elapsed = std::chrono::steady_clock::now() - start;
+            PrintRunSummary(submittedFrames - std::min(submittedFrames, m_Config.warmupFrames), elapsed.count());
+            PrintGpuSummary();
+        }
+
+        if (m_Config.benchmark)
+            WriteBenchmarkReport(cpuFrameMs);
+
+        if (m_Window)
+            PrintLatencySummary();
+    }
+
+    void Application::PrintLatencySummary() const
+    {
+        auto latency = m_Renderer->GetLatencyStats();
+        if (latency.sampleCount == 0)
+            return;
+
+        fmt::print("Input-to-present latency over {} frames: avg {:.3f} ms  min {:.3f} ms  max {:.3f} ms{}\n",
+            latency.sampleCount, latency.avgMs, latency.minMs, latency.maxMs,
+            m_Config.lowLatency ? " [low latency]" : ""
+        );
+    }
+
+    void Application::PrintGpuSummary() const
+    {
+        // Printed rather than logged so that release runs, the ones worth
+        // measuring, report per-pass GPU timings too.
+        std::string stats = VulkanGpuProfiler::FormatStats(m_Renderer->GetGpuStats());
+        if (!stats.empty())
+            fmt::print("{}\n", stats);
+    }
+
+    void Application::WriteBenchmarkReport(const std::vector<f64>& cpuFrameMs)
+    {
+        Benchmark benchmark;
+        benchmark.Reserve(cpuFrameMs.size());
+
+        for (const auto& stats : m_Renderer->ConsumeFrameStats()) {
+            if (stats.frame <= m_Config.warmupFrames)
+                continue;
+
+            u64 index = stats.frame - m_Config.warmupFrames - 1;
+            if (index >= cpuFrameMs.size())
+                continue;
+
+            benchmark.AddSample(Benchmark::Sample {
+                .frame = index,
+                .cpuMs = cpuFrameMs[index],
+                .renderMs = stats.renderMs,
+                .presentMs = stats.presentMs,
+                .gpuMs = stats.gpuMs,
+                .renderScale = stats.renderScale
+            });
+        }
+
+        if (benchmark.GetSampleCount() != cpuFrameMs.size()) {
+            LOG_WARN("Benchmark dropped {} frames without render timings", cpuFrameMs.size() - benchmark.GetSampleCount())
+        }
+
+        benchmark.PrintReport();
+        benchmark.WriteSamples(m_Config.benchmarkOutput + ".csv");
+        benchmark.WriteSummary(m_Config.benchmarkOutput + "_Summary.csv");
+    }
+
+    void Application::PrintRunSummary(u64 frames, f64 seconds) const
+    {
+        fmt::print("Rendered {} frames in {:.3f} s ({:.3f} ms/frame, {:.1f} fps){}\n",
+            frames, seconds,
+            frames != 0 ? seconds * 1000.0 / static_cast<f64>(frames) : 0.0,
+            seconds > 0.0 ? static_cast<f64>(frames) / seconds : 0.0,
+            m_Config.headless ? " [headless]" : ""
+        );
+
+        // Run once per --schedule mode to compare the optimized order against
+        // the naive one.
+        auto schedule = m_Renderer->GetScheduleSummary();
+
+        std::string criticalPath;
+        for (const auto& pass : schedule.criticalPath)
+            criticalPath += criticalPath.empty() ? pass : " -> " + pass;
+
+        fmt::print("Render graph ({} schedule): {} barriers in {} batches, critical path {} passes ({})\n",
+            schedule.mode == ScheduleMode::Optimized ? "optimized" : "naive",
+            schedule.stats.barrierCount, schedule.stats.barrierBatchCount,
+            schedule.stats.criticalPathLength, criticalPath
+        );
     }
 
     void Application::ProcessEvents()
     {
+        PROFILE_SCOPE("Application::ProcessEvents")
+
         for (auto& event : m_EventQueue->Poll()) {
             EventDispatcher dispatcher(event);
 
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "Types.hpp"
 #include "Events.hpp"
 #include "Window.hpp"
@@ -10,9 +13,33 @@ namespace Renderer {
     class Application
     {
     public:
-        Application();
+        struct Config
+        {
+            bool headless { false };
+            u32 width { 1280 };
+            u32 height { 720 };
+            u64 frameCount { 0 };
+            std::string device;
+            bool lowLatency { false };
+            bool shaderObjects { true };
+            ScheduleMode schedule { ScheduleMode::Naive };
+            DynamicResolution::Config dynamicResolution;
+            VulkanFrameCapture::Request capture;
+
+            bool benchmark { false };
+            u64 warmupFrames { 100 };
+            std::string benchmarkOutput { "logs/Benchmark" };
+
+            std::string profileOutput;
+            std::string graphDumpPath;
+        };
+
+    public:
+        Application(const Config& config);
         ~Application();
 
+        static Config ParseCommandLine(i32 argc, char** argv);
+
         static const Application& Get() { return *s_Instance; }
         inline const Window& GetWindow() const { return *m_Window; }
 
@@ -20,10 +47,16 @@ namespace Renderer {
 
     private:
         void ProcessEvents();
+        void PrintRunSummary(u64 frames, f64 seconds) const;
+        void PrintLatencySummary() const;
+        void PrintGpuSummary() const;
+        void WriteBenchmarkReport(const std::vector<f64>& cpuFrameMs);
 
     private:
         inline static Application* s_Instance { nullptr };
 
+        Config m_Config;
+
         bool m_Running { true };
         bool m_Minimized { false };
 
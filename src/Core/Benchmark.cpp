@@ -0,0 +1,121 @@
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include <spdlog/fmt/fmt.h>
+
+#include "Logger.hpp"
+
+namespace Renderer {
+
+    Benchmark::Statistics Benchmark::ComputeStatistics(Metric metric) const
+    {
+        if (m_Samples.empty())
+            return {};
+
+        std::vector<f64> sorted;
+        sorted.reserve(m_Samples.size());
+
+        f64 sum = 0.0;
+        for (const auto& sample : m_Samples) {
+            f64 value = GetValue(sample, metric);
+            sorted.push_back(value);
+            sum += value;
+        }
+
+        std::sort(sorted.begin(), sorted.end());
+
+        return Statistics {
+            .minMs = sorted.front(),
+            .meanMs = sum / static_cast<f64>(sorted.size()),
+            .p50Ms = Percentile(sorted, 50),
+            .p95Ms = Percentile(sorted, 95),
+            .p99Ms = Percentile(sorted, 99)
+        };
+    }
+
+    void Benchmark::PrintReport() const
+    {
+        fmt::print("Benchmark results over {} frames:\n", m_Samples.size());
+        for (u8 i = 0; i < static_cast<u8>(Metric::Count); ++i) {
+            Metric metric = static_cast<Metric>(i);
+            Statistics s = ComputeStatistics(metric);
+            fmt::print(" - {:<8} min {:.3f} ms  mean {:.3f} ms  p50 {:.3f} ms  p95 {:.3f} ms  p99 {:.3f} ms\n",
+                GetMetricName(metric), s.minMs, s.meanMs, s.p50Ms, s.p95Ms, s.p99Ms);
+        }
+    }
+
+    bool Benchmark::WriteSamples(const std::string& filepath) const
+    {
+        std::filesystem::path path(filepath);
+        if (path.has_parent_path())
+            std::filesystem::create_directories(path.parent_path());
+
+        std::ofstream file(filepath, std::ios::trunc);
+        if (!file.is_open()) {
+            LOG_ERROR("Failed to open file {}", filepath)
+            return false;
+        }
+
+        file << "frame,cpu_ms,render_ms,present_ms,gpu_ms,render_scale\n";
+        for (const auto& sample : m_Samples)
+            file << sample.frame << ',' << sample.cpuMs << ',' << sample.renderMs << ',' << sample.presentMs << ',' << sample.gpuMs << ',' << sample.renderScale << '\n';
+
+        return file.good();
+    }
+
+    bool Benchmark::WriteSummary(const std::string& filepath) const
+    {
+        std::filesystem::path path(filepath);
+        if (path.has_parent_path())
+            std::filesystem::create_directories(path.parent_path());
+
+        std::ofstream file(filepath, std::ios::trunc);
+        if (!file.is_open()) {
+            LOG_ERROR("Failed to open file {}", filepath)
+            return false;
+        }
+
+        file << "metric,samples,min_ms,mean_ms,p50_ms,p95_ms,p99_ms\n";
+        for (u8 i = 0; i < static_cast<u8>(Metric::Count); ++i) {
+            Metric metric = static_cast<Metric>(i);
+            Statistics s = ComputeStatistics(metric);
+            file << GetMetricName(metric) << ',' << m_Samples.size() << ','
+                 << s.minMs << ',' << s.meanMs << ',' << s.p50Ms << ',' << s.p95Ms << ',' << s.p99Ms << '\n';
+        }
+
+        return file.good();
+    }
+
+    const char* Benchmark::GetMetricName(Metric metric)
+    {
+        switch (metric) {
+            case Metric::Cpu:     return "cpu";
+            case Metric::Render:  return "render";
+            case Metric::Present: return "present";
+            case Metric::Gpu:     return "gpu";
+            default:              return "unknown";
+        }
+    }
+
+    f64 Benchmark::GetValue(const Sample& sample, Metric metric)
+    {
+        switch (metric) {
+            case Metric::Cpu:     return sample.cpuMs;
+            case Metric::Render:  return sample.renderMs;
+            case Metric::Present: return sample.presentMs;
+            case Metric::Gpu:     return sample.gpuMs;
+            default:              return 0.0;
+        }
+    }
+
+    f64 Benchmark::Percentile(const std::vector<f64>& sorted, u32 percent)
+    {
+        // Nearest-rank, so the reported value is always an observed sample.
+        usize rank = (sorted.size() * percent + 99) / 100;
+        return sorted[std::clamp<usize>(rank, 1, sorted.size()) - 1];
+    }
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Types.hpp"
+
+namespace Renderer {
+
+    class Benchmark
+    {
+    public:
+        struct Sample
+        {
+            u64 frame { 0 };
+            f64 cpuMs { 0.0 };
+            f64 renderMs { 0.0 };
+            f64 presentMs { 0.0 };
+            f64 gpuMs { 0.0 };
+            f32 renderScale { 1.0f };
+        };
+
+        struct Statistics
+        {
+            f64 minMs { 0.0 };
+            f64 meanMs { 0.0 };
+            f64 p50Ms { 0.0 };
+            f64 p95Ms { 0.0 };
+            f64 p99Ms { 0.0 };
+        };
+
+        enum class Metric : u8
+        {
+            Cpu,
+            Render,
+            Present,
+            Gpu,
+            Count
+        };
+
+    public:
+        inline void Reserve(usize count) { m_Samples.reserve(count); }
+        inline void AddSample(const Sample& sample) { m_Samples.push_back(sample); }
+        inline usize GetSampleCount() const { return m_Samples.size(); }
+
+        Statistics ComputeStatistics(Metric metric) const;
+
+        void PrintReport() const;
+        bool WriteSamples(const std::string& filepath) const;
+        bool WriteSummary(const std::string& filepath) const;
+
+        static const char* GetMetricName(Metric metric);
+
+    private:
+        static f64 GetValue(const Sample& sample, Metric metric);
+        static f64 Percentile(const std::vector<f64>& sorted, u32 percent);
+
+    private:
+        std::vector<Sample> m_Samples;
+    };
+
+}
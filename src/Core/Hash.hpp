@@ -0,0 +1,19 @@
+#pragma once
+
+#include <span>
+
+#include "Types.hpp"
+
+namespace Renderer {
+
+    inline u64 HashBytes(std::span<const u8> bytes, u64 seed = 14695981039346656037ull)
+    {
+        u64 hash = seed;
+        for (u8 byte : bytes) {
+            hash ^= byte;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+}
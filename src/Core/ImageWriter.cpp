@@ -0,0 +1,146 @@
+#include "ImageWriter.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "Logger.hpp"
+
+namespace Renderer {
+
+    bool ImageWriter::WritePng(const std::string& filepath, u32 width, u32 height, const u8* rgba)
+    {
+        std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            LOG_ERROR("Failed to open file {}", filepath)
+            return false;
+        }
+
+        static constexpr u8 signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+        u8 header[13] {};
+        WriteBigEndian(header + 0, width);
+        WriteBigEndian(header + 4, height);
+        header[8] = 8;  // bit depth
+        header[9] = 6;  // RGBA
+        WriteChunk(file, "IHDR", header, sizeof(header));
+
+        // Deflate "stored" blocks: no compression, so encoding stays cheap
+        // enough to keep up with sequence capture.
+        static constexpr usize maxBlockSize = 65535;
+
+        usize rowSize = static_cast<usize>(width) * 4;
+        usize rawSize = (rowSize + 1) * height;
+        usize blockCount = std::max<usize>(1, (rawSize + maxBlockSize - 1) / maxBlockSize);
+
+        std::vector<u8> raw;
+        raw.reserve(rawSize);
+        for (u32 y = 0; y < height; ++y) {
+            raw.push_back(0);
+            raw.insert(raw.end(), rgba + y * rowSize, rgba + (y + 1) * rowSize);
+        }
+
+        std::vector<u8> idat;
+        idat.reserve(2 + rawSize + blockCount * 5 + 4);
+        idat.push_back(0x78);
+        idat.push_back(0x01);
+
+        u32 adlerA = 1;
+        u32 adlerB = 0;
+
+        usize offset = 0;
+        do {
+            usize blockSize = std::min(maxBlockSize, rawSize - offset);
+            bool last = offset + blockSize == rawSize;
+
+            idat.push_back(last ? 1 : 0);
+            idat.push_back(static_cast<u8>(blockSize & 0xFF));
+            idat.push_back(static_cast<u8>(blockSize >> 8));
+            idat.push_back(static_cast<u8>(~blockSize & 0xFF));
+            idat.push_back(static_cast<u8>((~blockSize >> 8) & 0xFF));
+
+            for (usize i = offset; i < offset + blockSize; ++i) {
+                adlerA = (adlerA + raw[i]) % 65521;
+                adlerB = (adlerB + adlerA) % 65521;
+            }
+
+            idat.insert(idat.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+            offset += blockSize;
+        } while (offset < rawSize);
+
+        u8 adler[4];
+        WriteBigEndian(adler, (adlerB << 16) | adlerA);
+        idat.insert(idat.end(), adler, adler + 4);
+
+        WriteChunk(file, "IDAT", idat.data(), idat.size());
+        WriteChunk(file, "IEND", nullptr, 0);
+
+        return file.good();
+    }
+
+    bool ImageWriter::WriteRaw(const std::string& filepath, const u8* data, usize size)
+    {
+        std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            LOG_ERROR("Failed to open file {}", filepath)
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        return file.good();
+    }
+
+    void ImageWriter::WriteChunk(std::ofstream& file, const char* type, const u8* data, usize size)
+    {
+        u8 length[4];
+        WriteBigEndian(length, static_cast<u32>(size));
+        file.write(reinterpret_cast<const char*>(length), 4);
+        file.write(type, 4);
+
+        if (size != 0)
+            file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+
+        u32 crc = UpdateCrc(0xFFFFFFFFu, reinterpret_cast<const u8*>(type), 4);
+        if (size != 0)
+            crc = UpdateCrc(crc, data, size);
+
+        u8 crcBytes[4];
+        WriteBigEndian(crcBytes, crc ^ 0xFFFFFFFFu);
+        file.write(reinterpret_cast<const char*>(crcBytes), 4);
+    }
+
+    void ImageWriter::WriteBigEndian(u8* out, u32 value)
+    {
+        out[0] = static_cast<u8>(value >> 24);
+        out[1] = static_cast<u8>(value >> 16);
+        out[2] = static_cast<u8>(value >> 8);
+        out[3] = static_cast<u8>(value);
+    }
+
+    u32 ImageWriter::UpdateCrc(u32 crc, const u8* data, usize size)
+    {
+        const auto& table = GetCrcTable();
+
+        for (usize i = 0; i < size; ++i)
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+        return crc;
+    }
+
+    const std::array<u32, 256>& ImageWriter::GetCrcTable()
+    {
+        static const std::array<u32, 256> table = [] {
+            std::array<u32, 256> t {};
+            for (u32 n = 0; n < 256; ++n) {
+                u32 c = n;
+                for (u32 k = 0; k < 8; ++k)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[n] = c;
+            }
+            return t;
+        }();
+
+        return table;
+    }
+
+}
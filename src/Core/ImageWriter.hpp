@@ -0,0 +1,25 @@
+#pragma once
+
+#include <array>
+#include <fstream>
+#include <string>
+
+#include "Types.hpp"
+
+namespace Renderer {
+
+    class ImageWriter
+    {
+    public:
+        static bool WritePng(const std::string& filepath, u32 width, u32 height, const u8* rgba);
+        static bool WriteRaw(const std::string& filepath, const u8* data, usize size);
+
+    private:
+        static void WriteChunk(std::ofstream& file, const char* type, const u8* data, usize size);
+        static void WriteBigEndian(u8* out, u32 value);
+
+        static u32 UpdateCrc(u32 crc, const u8* data, usize size);
+        static const std::array<u32, 256>& GetCrcTable();
+    };
+
+}
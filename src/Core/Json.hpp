@@ -0,0 +1,37 @@
+#pragma once
+
+#include <ostream>
+#include <string_view>
+
+namespace Renderer {
+
+    // Streams a quoted JSON string, escaping quotes, backslashes and every
+    // control character.
+    struct JsonString
+    {
+        std::string_view value;
+    };
+
+    inline std::ostream& operator<<(std::ostream& out, JsonString str)
+    {
+        static constexpr char s_Hex[] = "0123456789abcdef";
+
+        out << '"';
+        for (char c : str.value) {
+            switch (c) {
+                case '"':  out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n"; break;
+                case '\r': out << "\\r"; break;
+                case '\t': out << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                        out << "\\u00" << s_Hex[(c >> 4) & 0xf] << s_Hex[c & 0xf];
+                    else
+                        out << c;
+            }
+        }
+        return out << '"';
+    }
+
+}
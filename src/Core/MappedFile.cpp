@@ -0,0 +1,87 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "Logger.hpp"
+
+namespace Renderer {
+
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::string& filepath)
+    {
+        HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            LOG_ERROR("Failed to open file {}", filepath)
+            return;
+        }
+        m_File = file;
+
+        LARGE_INTEGER size {};
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+            return;
+
+        m_Mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_Mapping) {
+            LOG_ERROR("Failed to map file {}", filepath)
+            return;
+        }
+
+        m_Data = static_cast<const u8*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+        if (m_Data)
+            m_Size = static_cast<usize>(size.QuadPart);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_Data)
+            UnmapViewOfFile(m_Data);
+        if (m_Mapping)
+            CloseHandle(m_Mapping);
+        if (m_File)
+            CloseHandle(m_File);
+    }
+#else
+    MappedFile::MappedFile(const std::string& filepath)
+    {
+        int fd = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            LOG_ERROR("Failed to open file {}", filepath)
+            return;
+        }
+
+        struct stat info {};
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* data = mmap(nullptr, static_cast<usize>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                m_Data = static_cast<const u8*>(data);
+                m_Size = static_cast<usize>(info.st_size);
+            } else {
+                LOG_ERROR("Failed to map file {}", filepath)
+            }
+        }
+
+        // The mapping keeps the file referenced after the descriptor is closed.
+        close(fd);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_Data)
+            munmap(const_cast<u8*>(m_Data), m_Size);
+    }
+#endif
+
+}
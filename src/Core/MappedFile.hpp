@@ -0,0 +1,34 @@
+#pragma once
+
+#include <span>
+#include <string>
+
+#include "Types.hpp"
+
+namespace Renderer {
+
+    class MappedFile
+    {
+    public:
+        MappedFile(const std::string& filepath);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        inline bool IsOpen() const { return m_Data != nullptr; }
+        inline const u8* GetData() const { return m_Data; }
+        inline usize GetSize() const { return m_Size; }
+        inline std::span<const u8> GetBytes() const { return { m_Data, m_Size }; }
+
+    private:
+        const u8* m_Data { nullptr };
+        usize m_Size { 0 };
+
+#ifdef _WIN32
+        void* m_File { nullptr };
+        void* m_Mapping { nullptr };
+#endif
+    };
+
+}
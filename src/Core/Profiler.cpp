@@ -0,0 +1,140 @@
+#include "Profiler.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <string_view>
+
+#include "Json.hpp"
+#include "Logger.hpp"
+
+namespace Renderer {
+
+    void Profiler::BeginSession()
+    {
+        BeginSession(Config {});
+    }
+
+    void Profiler::BeginSession(const Config& config)
+    {
+        std::lock_guard<std::mutex> lock(s_RegistryMutex);
+
+        s_MaxEventsPerThread.store(config.maxEventsPerThread, std::memory_order_relaxed);
+        s_SessionStartNs = Now();
+        s_Session.fetch_add(1, std::memory_order_acq_rel);
+        s_Active.store(true, std::memory_order_release);
+    }
+
+    void Profiler::EndSession()
+    {
+        s_Active.store(false, std::memory_order_release);
+    }
+
+    void Profiler::SetThreadName(const std::string& name)
+    {
+        ThreadBuffer& buffer = GetThreadBuffer();
+
+        std::lock_guard<std::mutex> lock(s_RegistryMutex);
+        buffer.threadName = name;
+    }
+
+    void Profiler::RecordZone(const char* name, i64 startNs, i64 endNs)
+    {
+        if (!IsActive())
+            return;
+
+        ThreadBuffer& buffer = GetThreadBuffer();
+
+        // Only the owning thread writes to its buffer; a new session is
+        // picked up lazily here instead of clearing every buffer up front.
+        u32 session = s_Session.load(std::memory_order_acquire);
+        if (buffer.session.load(std::memory_order_relaxed) != session) {
+            buffer.events.resize(s_MaxEventsPerThread.load(std::memory_order_relaxed));
+            buffer.count.store(0, std::memory_order_relaxed);
+            buffer.dropped.store(0, std::memory_order_relaxed);
+            buffer.session.store(session, std::memory_order_release);
+        }
+
+        usize index = buffer.count.load(std::memory_order_relaxed);
+        if (index >= buffer.events.size()) {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        buffer.events[index] = ZoneEvent {
+            .name = name,
+            .startNs = startNs,
+            .durationNs = endNs - startNs
+        };
+        buffer.count.store(index + 1, std::memory_order_release);
+    }
+
+    bool Profiler::WriteChromeTrace(const std::string& filepath)
+    {
+        std::ofstream file(filepath, std::ios::trunc);
+        if (!file.is_open()) {
+            LOG_ERROR("Failed to open file {}", filepath)
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(s_RegistryMutex);
+
+        u32 session = s_Session.load(std::memory_order_acquire);
+        usize eventCount = 0;
+
+        file << std::fixed << std::setprecision(3);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        bool first = true;
+        for (const auto& buffer : s_Buffers) {
+            if (!buffer->threadName.empty()) {
+                file << (first ? "\n" : ",\n")
+                     << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->threadId
+                     << ",\"args\":{\"name\":" << JsonString { buffer->threadName } << "}}";
+                first = false;
+            }
+
+            if (buffer->session.load(std::memory_order_acquire) != session)
+                continue;
+
+            usize count = buffer->count.load(std::memory_order_acquire);
+            for (usize i = 0; i < count; ++i) {
+                const ZoneEvent& event = buffer->events[i];
+
+                file << (first ? "\n" : ",\n")
+                     << "{\"name\":" << JsonString { event.name } << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->threadId
+                     << ",\"ts\":" << static_cast<f64>(event.startNs - s_SessionStartNs) / 1000.0
+                     << ",\"dur\":" << static_cast<f64>(event.durationNs) / 1000.0 << "}";
+                first = false;
+            }
+
+            eventCount += count;
+            if (usize dropped = buffer->dropped.load(std::memory_order_relaxed); dropped != 0) {
+                LOG_WARN("Profiler dropped {} zones on thread {}", dropped, buffer->threadId)
+            }
+        }
+
+        file << "\n]}\n";
+
+        LOG_INFO("Wrote {} profiler zones to {}", eventCount, filepath)
+
+        return true;
+    }
+
+    Profiler::ThreadBuffer& Profiler::GetThreadBuffer()
+    {
+        thread_local ThreadBuffer* t_Buffer = nullptr;
+
+        if (t_Buffer == nullptr) {
+            std::lock_guard<std::mutex> lock(s_RegistryMutex);
+
+            auto buffer = CreateScope<ThreadBuffer>();
+            buffer->threadId = static_cast<u32>(s_Buffers.size());
+
+            t_Buffer = buffer.get();
+            s_Buffers.push_back(std::move(buffer));
+        }
+
+        return *t_Buffer;
+    }
+
+}
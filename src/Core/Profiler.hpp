@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Types.hpp"
+
+namespace Renderer {
+
+    class Profiler
+    {
+    public:
+        struct Config
+        {
+            usize maxEventsPerThread { 1 << 18 };
+        };
+
+        struct ZoneEvent
+        {
+            const char* name { nullptr };
+            i64 startNs { 0 };
+            i64 durationNs { 0 };
+        };
+
+    public:
+        static void BeginSession();
+        static void BeginSession(const Config& config);
+        static void EndSession();
+        inline static bool IsActive() { return s_Active.load(std::memory_order_relaxed); }
+
+        static void SetThreadName(const std::string& name);
+        static void RecordZone(const char* name, i64 startNs, i64 endNs);
+
+        static bool WriteChromeTrace(const std::string& filepath);
+
+        inline static i64 Now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+    private:
+        struct ThreadBuffer
+        {
+            u32 threadId { 0 };
+            std::string threadName;
+
+            std::vector<ZoneEvent> events;
+            std::atomic<usize> count { 0 };
+            std::atomic<u32> session { 0 };
+            std::atomic<usize> dropped { 0 };
+        };
+
+    private:
+        static ThreadBuffer& GetThreadBuffer();
+
+    private:
+        inline static std::atomic<bool> s_Active { false };
+        inline static std::atomic<u32> s_Session { 0 };
+        inline static std::atomic<usize> s_MaxEventsPerThread { 0 };
+        inline static i64 s_SessionStartNs { 0 };
+
+        inline static std::mutex s_RegistryMutex;
+        inline static std::vector<std::unique_ptr<ThreadBuffer>> s_Buffers;
+    };
+
+    class ProfileZone
+    {
+    public:
+        ProfileZone(const char* name)
+            : m_Name(name), m_StartNs(Profiler::IsActive() ? Profiler::Now() : 0)
+        {
+        }
+
+        ~ProfileZone()
+        {
+            if (m_StartNs != 0)
+                Profiler::RecordZone(m_Name, m_StartNs, Profiler::Now());
+        }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+    private:
+        const char* m_Name;
+        i64 m_StartNs;
+    };
+
+}
+
+#if !defined(NDEBUG) || defined(RENDERER_ENABLE_PROFILING)
+    #define PROFILE_CONCAT_INNER(a, b) a##b
+    #define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+    #define PROFILE_SCOPE(name) ::Renderer::ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name);
+    #define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+    #define PROFILE_THREAD(name) ::Renderer::Profiler::SetThreadName(name);
+    #define PROFILE_BEGIN_SESSION() ::Renderer::Profiler::BeginSession();
+    #define PROFILE_END_SESSION(filepath) ::Renderer::Profiler::EndSession(); ::Renderer::Profiler::WriteChromeTrace(filepath);
+#else
+    #define PROFILE_SCOPE(name)
+    #define PROFILE_FUNCTION()
+    #define PROFILE_THREAD(name)
+    #define PROFILE_BEGIN_SESSION()
+    #define PROFILE_END_SESSION(filepath)
+#endif
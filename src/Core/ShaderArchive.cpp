@@ -0,0 +1,374 @@
+#include "ShaderArchive.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#elif defined(__APPLE__)
+    #include <mach-o/dyld.h>
+#endif
+
+#include "Hash.hpp"
+#include "Logger.hpp"
+
+namespace Renderer {
+
+    ShaderArchive::ShaderArchive(const std::string& filepath)
+        : m_Path(filepath), m_File(filepath)
+    {
+        if (!m_File.IsOpen())
+            return;
+
+        const u8* base = m_File.GetData();
+        usize size = m_File.GetSize();
+
+        if (size < sizeof(Header)) {
+            LOG_ERROR("Shader archive {} is truncated", filepath)
+            return;
+        }
+
+        const Header* header = reinterpret_cast<const Header*>(base);
+        if (header->magic != s_Magic || header->version != s_Version) {
+            LOG_ERROR("Shader archive {} has an unsupported format", filepath)
+            return;
+        }
+
+        usize tocSize = static_cast<usize>(header->entryCount) * sizeof(TocEntry);
+        if (header->tocOffset % alignof(TocEntry) != 0 || header->tocOffset + tocSize > size || header->namesOffset > size) {
+            LOG_ERROR("Shader archive {} has a corrupt table of contents", filepath)
+            return;
+        }
+
+        m_Entries = { reinterpret_cast<const TocEntry*>(base + header->tocOffset), header->entryCount };
+        m_Names = { reinterpret_cast<const char*>(base + header->namesOffset), size - header->namesOffset };
+
+        for (const auto& entry : m_Entries) {
+            if (entry.dataOffset + entry.storedSize > size || static_cast<usize>(entry.nameOffset) + entry.nameLength > m_Names.size()) {
+                LOG_ERROR("Shader archive {} has a corrupt entry", filepath)
+                m_Entries = {};
+                return;
+            }
+        }
+
+        m_Verification.assign(m_Entries.size(), Verification::Pending);
+        m_Header = header;
+        LOG_INFO("Opened shader archive {} ({} shaders)", filepath, m_Entries.size())
+    }
+
+    std::optional<ShaderArchive::Blob> ShaderArchive::Find(const std::string& name) const
+    {
+        if (!IsOpen())
+            return std::nullopt;
+
+        // Entries are sorted by name when the archive is written.
+        auto it = std::lower_bound(m_Entries.begin(), m_Entries.end(), name, [this](const TocEntry& entry, const std::string& value) {
+            return GetName(entry) < value;
+        });
+        if (it == m_Entries.end() || GetName(*it) != name)
+            return std::nullopt;
+
+        const TocEntry& entry = *it;
+        usize index = static_cast<usize>(it - m_Entries.begin());
+        std::span<const u8> data { m_File.GetData() + entry.dataOffset, static_cast<usize>(entry.storedSize) };
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (entry.compression != Compression::None) {
+            auto cached = m_Decompressed.find(index);
+            if (cached == m_Decompressed.end()) {
+                std::vector<u8> decompressed;
+                if (entry.compression != Compression::Lz || !Decompress(data, decompressed, static_cast<usize>(entry.size))) {
+                    LOG_ERROR("Failed to decompress {} from {}", name, m_Path)
+                    return std::nullopt;
+                }
+                cached = m_Decompressed.emplace(index, std::move(decompressed)).first;
+            }
+            data = cached->second;
+        }
+
+        // The hash is also the shader cache key, so a damaged blob is caught
+        // here once rather than handed to the driver.
+        Verification& verification = m_Verification.at(index);
+        if (verification == Verification::Pending)
+            verification = HashBytes(data) == entry.hash ? Verification::Valid : Verification::Corrupt;
+
+        if (verification == Verification::Corrupt) {
+            LOG_ERROR("Shader {} in {} does not match its hash", name, m_Path)
+            return std::nullopt;
+        }
+
+        return Blob { .data = data, .hash = entry.hash };
+    }
+
+    std::vector<std::string> ShaderArchive::GetNames() const
+    {
+        std::vector<std::string> names;
+        names.reserve(m_Entries.size());
+        for (const auto& entry : m_Entries)
+            names.emplace_back(GetName(entry));
+        return names;
+    }
+
+    bool ShaderArchive::Write(const std::string& filepath, std::vector<Source> sources, bool compress)
+    {
+        std::sort(sources.begin(), sources.end(), [](const Source& a, const Source& b) {
+            return a.name < b.name;
+        });
+
+        // Lookups are by name, so a second entry with the same name could
+        // never be found.
+        auto duplicate = std::adjacent_find(sources.begin(), sources.end(), [](const Source& a, const Source& b) {
+            return a.name == b.name;
+        });
+        if (duplicate != sources.end()) {
+            LOG_ERROR("Shader archive {} would contain {} twice", filepath, duplicate->name)
+            return false;
+        }
+
+        auto alignUp = [](u64 value, u64 alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        };
+
+        std::vector<TocEntry> entries;
+        std::vector<std::vector<u8>> blobs;
+        std::string names;
+        entries.reserve(sources.size());
+        blobs.reserve(sources.size());
+
+        u64 offset = alignUp(sizeof(Header), s_Alignment);
+        for (auto& source : sources) {
+            TocEntry entry {
+                .nameOffset = static_cast<u32>(names.size()),
+                .nameLength = static_cast<u32>(source.name.size()),
+                .dataOffset = offset,
+                .storedSize = source.data.size(),
+                .size = source.data.size(),
+                .hash = HashBytes(source.data),
+                .compression = Compression::None,
+                .reserved = 0
+            };
+            names += source.name;
+
+            if (compress) {
+                std::vector<u8> compressed = Compress(source.data);
+                if (compressed.size() < source.data.size()) {
+                    entry.storedSize = compressed.size();
+                    entry.compression = Compression::Lz;
+                    source.data = std::move(compressed);
+                }
+            }
+
+            offset = alignUp(offset + entry.storedSize, s_Alignment);
+            entries.push_back(entry);
+            blobs.push_back(std::move(source.data));
+        }
+
+        Header header {
+            .magic = s_Magic,
+            .version = s_Version,
+            .entryCount = static_cast<u32>(entries.size()),
+            .alignment = s_Alignment,
+            .tocOffset = offset,
+            .namesOffset = offset + entries.size() * sizeof(TocEntry)
+        };
+
+        std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            LOG_ERROR("Failed to open file {}", filepath)
+            return false;
+        }
+
+        static constexpr std::array<char, s_Alignment> padding {};
+        auto pad = [&]() {
+            u64 position = static_cast<u64>(file.tellp());
+            file.write(padding.data(), static_cast<std::streamsize>(alignUp(position, s_Alignment) - position));
+        };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        pad();
+        for (const auto& blob : blobs) {
+            file.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+            pad();
+        }
+        file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(TocEntry)));
+        file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+        return file.good();
+    }
+
+    std::string ShaderArchive::GetDefaultPath()
+    {
+        // The archive is placed next to the executable, so lookups do not
+        // depend on the working directory.
+        return (GetExecutableDirectory() / s_DefaultFilename).string();
+    }
+
+    std::string ShaderArchive::GetLooseShaderPath(const std::string& name)
+    {
+        // Compiled SPIR-V is written to shaders/ beside the bin/ directory
+        // that holds the executable.
+        return (GetExecutableDirectory() / ".." / "shaders" / name).string();
+    }
+
+    std::vector<u8> ShaderArchive::Compress(std::span<const u8> data)
+    {
+        // LZ4-style sequences: a token holding the literal and match lengths,
+        // the literals, then a 16-bit match offset. The last sequence carries
+        // literals only.
+        static constexpr usize minMatch = 4;
+        static constexpr usize hashBits = 12;
+
+        std::vector<u8> out;
+        out.reserve(data.size());
+
+        auto read32 = [&](usize at) {
+            u32 value;
+            std::memcpy(&value, data.data() + at, sizeof(value));
+            return value;
+        };
+
+        auto writeLength = [&](usize length) {
+            for (; length >= 255; length -= 255)
+                out.push_back(255);
+            out.push_back(static_cast<u8>(length));
+        };
+
+        auto emit = [&](usize literalStart, usize literalEnd, usize offset, usize matchLength) {
+            usize literals = literalEnd - literalStart;
+            usize match = matchLength > 0 ? matchLength - minMatch : 0;
+
+            out.push_back(static_cast<u8>((std::min<usize>(literals, 15) << 4) | std::min<usize>(match, 15)));
+            if (literals >= 15)
+                writeLength(literals - 15);
+            out.insert(out.end(), data.begin() + static_cast<std::ptrdiff_t>(literalStart), data.begin() + static_cast<std::ptrdiff_t>(literalEnd));
+
+            if (matchLength == 0)
+                return;
+
+            out.push_back(static_cast<u8>(offset & 0xFF));
+            out.push_back(static_cast<u8>(offset >> 8));
+            if (match >= 15)
+                writeLength(match - 15);
+        };
+
+        std::array<u32, usize{1} << hashBits> table;
+        table.fill(std::numeric_limits<u32>::max());
+
+        usize anchor = 0;
+        usize i = 0;
+        while (i + minMatch <= data.size()) {
+            u32 sequence = read32(i);
+            u32 slot = (sequence * 2654435761u) >> (32 - hashBits);
+            u32 candidate = table[slot];
+            table[slot] = static_cast<u32>(i);
+
+            if (candidate == std::numeric_limits<u32>::max() || i - candidate > 0xFFFF || read32(candidate) != sequence) {
+                ++i;
+                continue;
+            }
+
+            usize length = minMatch;
+            while (i + length < data.size() && data[candidate + length] == data[i + length])
+                ++length;
+
+            emit(anchor, i, i - candidate, length);
+            i += length;
+            anchor = i;
+        }
+
+        emit(anchor, data.size(), 0, 0);
+        return out;
+    }
+
+    bool ShaderArchive::Decompress(std::span<const u8> data, std::vector<u8>& out, usize size)
+    {
+        out.clear();
+        out.reserve(size);
+
+        usize ip = 0;
+        auto readLength = [&](usize length) -> std::optional<usize> {
+            u8 byte = 255;
+            while (byte == 255) {
+                if (ip >= data.size())
+                    return std::nullopt;
+                byte = data[ip++];
+                length += byte;
+            }
+            return length;
+        };
+
+        while (ip < data.size()) {
+            u8 token = data[ip++];
+
+            std::optional<usize> literals = token >> 4;
+            if (*literals == 15)
+                literals = readLength(*literals);
+            if (!literals || ip + *literals > data.size() || out.size() + *literals > size)
+                return false;
+
+            out.insert(out.end(), data.begin() + static_cast<std::ptrdiff_t>(ip), data.begin() + static_cast<std::ptrdiff_t>(ip + *literals));
+            ip += *literals;
+
+            if (ip == data.size())
+                break;
+            if (ip + 2 > data.size())
+                return false;
+
+            usize offset = static_cast<usize>(data[ip]) | (static_cast<usize>(data[ip + 1]) << 8);
+            ip += 2;
+
+            std::optional<usize> match = token & 15;
+            if (*match == 15)
+                match = readLength(*match);
+            if (!match || offset == 0 || offset > out.size() || out.size() + *match + 4 > size)
+                return false;
+
+            // Matches may overlap the bytes they produce, so copy one at a time.
+            usize from = out.size() - offset;
+            for (usize n = 0; n < *match + 4; ++n)
+                out.push_back(out[from + n]);
+        }
+
+        return out.size() == size;
+    }
+
+    std::string_view ShaderArchive::GetName(const TocEntry& entry) const
+    {
+        return { m_Names.data() + entry.nameOffset, entry.nameLength };
+    }
+
+    std::filesystem::path ShaderArchive::GetExecutableDirectory()
+    {
+        std::filesystem::path executable;
+
+#if defined(_WIN32)
+        std::array<char, MAX_PATH> buffer {};
+        DWORD length = GetModuleFileNameA(nullptr, buffer.data(), static_cast<DWORD>(buffer.size()));
+        if (length > 0 && length < buffer.size())
+            executable = std::string(buffer.data(), length);
+#elif defined(__APPLE__)
+        std::array<char, 4096> buffer {};
+        u32 length = static_cast<u32>(buffer.size());
+        if (_NSGetExecutablePath(buffer.data(), &length) == 0)
+            executable = buffer.data();
+#else
+        std::error_code error;
+        executable = std::filesystem::read_symlink("/proc/self/exe", error);
+#endif
+
+        // Relative paths resolve against the working directory as before
+        // when the executable cannot be located.
+        return executable.parent_path();
+    }
+
+}
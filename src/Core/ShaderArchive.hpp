@@ -0,0 +1,106 @@
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Types.hpp"
+#include "MappedFile.hpp"
+
+namespace Renderer {
+
+    class ShaderArchive
+    {
+    public:
+        inline static constexpr u32 s_Magic { 0x4B505352 }; // "RSPK"
+        inline static constexpr u32 s_Version { 1 };
+        inline static constexpr u32 s_Alignment { 16 };
+        inline static const std::string s_DefaultFilename { "shaders.pak" };
+
+        enum class Compression : u32
+        {
+            None = 0,
+            Lz = 1
+        };
+
+        struct Header
+        {
+            u32 magic { s_Magic };
+            u32 version { s_Version };
+            u32 entryCount { 0 };
+            u32 alignment { s_Alignment };
+            u64 tocOffset { 0 };
+            u64 namesOffset { 0 };
+        };
+
+        struct TocEntry
+        {
+            u32 nameOffset { 0 };
+            u32 nameLength { 0 };
+            u64 dataOffset { 0 };
+            u64 storedSize { 0 };
+            u64 size { 0 };
+            u64 hash { 0 };
+            Compression compression { Compression::None };
+            u32 reserved { 0 };
+        };
+
+        struct Source
+        {
+            std::string name;
+            std::vector<u8> data;
+        };
+
+        struct Blob
+        {
+            std::span<const u8> data;
+            u64 hash { 0 };
+        };
+
+    public:
+        ShaderArchive(const std::string& filepath);
+
+        inline bool IsOpen() const { return m_Header != nullptr; }
+        inline const std::string& GetPath() const { return m_Path; }
+        inline usize GetEntryCount() const { return m_Entries.size(); }
+
+        std::optional<Blob> Find(const std::string& name) const;
+        std::vector<std::string> GetNames() const;
+
+        static bool Write(const std::string& filepath, std::vector<Source> sources, bool compress);
+        static std::string GetDefaultPath();
+        static std::string GetLooseShaderPath(const std::string& name);
+
+        static std::vector<u8> Compress(std::span<const u8> data);
+        static bool Decompress(std::span<const u8> data, std::vector<u8>& out, usize size);
+
+    private:
+        enum class Verification : u8
+        {
+            Pending,
+            Valid,
+            Corrupt
+        };
+
+    private:
+        std::string_view GetName(const TocEntry& entry) const;
+        static std::filesystem::path GetExecutableDirectory();
+
+    private:
+        std::string m_Path;
+        MappedFile m_File;
+
+        const Header* m_Header { nullptr };
+        std::span<const TocEntry> m_Entries;
+        std::span<const char> m_Names;
+
+        mutable std::mutex m_Mutex;
+        mutable std::unordered_map<usize, std::vector<u8>> m_Decompressed;
+        mutable std::vector<Verification> m_Verification;
+    };
+
+}
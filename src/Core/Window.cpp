@@ -4,6 +4,7 @@
 #include <GLFW/glfw3native.h>
 
 #include "Logger.hpp"
+#include "Profiler.hpp"
 #include "Renderer/Vulkan/VulkanTypes.hpp"
 
 namespace Renderer {
@@ -126,6 +127,8 @@ namespace Renderer {
 
     void Window::PollEvents()
     {
+        PROFILE_SCOPE("Window::PollEvents")
+
         glfwPollEvents();
     }
 
@@ -1,14 +1,26 @@
 #include "Core/Logger.hpp"
+#include "Core/Profiler.hpp"
 #include "Core/Application.hpp"
 
-int main()
+int main(int argc, char** argv)
 {
     Renderer::Logger::Init();
 
+    // Profiling is opt-in so that ordinary debug runs do not pay for
+    // recording every zone or leave a trace behind.
+    Renderer::Application::Config config = Renderer::Application::ParseCommandLine(argc, argv);
+    bool profile = !config.profileOutput.empty();
+    if (profile) {
+        PROFILE_BEGIN_SESSION()
+    }
+
     {
-        Renderer::Application app;
+        Renderer::Application app(config);
         app.Run();
     }
 
+    if (profile) {
+        PROFILE_END_SESSION(config.profileOutput)
+    }
     Renderer::Logger::Shutdown();
 }
@@ -0,0 +1,55 @@
+#include "DynamicResolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Renderer {
+
+    DynamicResolution::DynamicResolution(const Config& config)
+        : m_Config(config)
+    {
+        m_Config.maxScale = std::clamp(m_Config.maxScale, 0.1f, 1.0f);
+        m_Config.minScale = std::clamp(m_Config.minScale, 0.1f, m_Config.maxScale);
+        m_Scale = m_Config.maxScale;
+    }
+
+    void DynamicResolution::Update(f64 gpuMs)
+    {
+        if (!m_Config.enabled || gpuMs <= 0.0)
+            return;
+
+        static constexpr f64 weight = 0.2;
+        m_GpuMs = m_GpuMs == 0.0 ? gpuMs : m_GpuMs + (gpuMs - m_GpuMs) * weight;
+
+        // GPU cost is roughly proportional to the pixel count, i.e. scale^2.
+        f32 desired = m_Scale * static_cast<f32>(std::sqrt(m_Config.targetGpuMs / m_GpuMs));
+
+        // Drop straight to the estimate when over budget, but grow slowly and
+        // only with headroom left, so that the scale does not oscillate.
+        if (m_GpuMs > m_Config.targetGpuMs)
+            m_Scale = desired;
+        else if (m_GpuMs < m_Config.targetGpuMs * (1.0 - m_Config.headroom))
+            m_Scale = std::min(desired, m_Scale + m_Config.maxStepUp);
+
+        m_Scale = std::clamp(m_Scale, m_Config.minScale, m_Config.maxScale);
+    }
+
+    VkExtent2D DynamicResolution::GetRenderExtent(VkExtent2D outputExtent) const
+    {
+        return ScaleExtent(outputExtent, m_Config.enabled ? m_Scale : 1.0f);
+    }
+
+    VkExtent2D DynamicResolution::GetMaxExtent(VkExtent2D outputExtent) const
+    {
+        return ScaleExtent(outputExtent, m_Config.enabled ? m_Config.maxScale : 1.0f);
+    }
+
+    VkExtent2D DynamicResolution::ScaleExtent(VkExtent2D extent, f32 scale)
+    {
+        return VkExtent2D {
+            .width = std::max(1u, static_cast<u32>(std::lround(static_cast<f32>(extent.width) * scale))),
+            .height = std::max(1u, static_cast<u32>(std::lround(static_cast<f32>(extent.height) * scale)))
+        };
+    }
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Core/Types.hpp"
+#include "Vulkan/VulkanTypes.hpp"
+
+namespace Renderer {
+
+    class DynamicResolution
+    {
+    public:
+        struct Config
+        {
+            bool enabled { false };
+            f64 targetGpuMs { 16.0 };
+            f32 minScale { 0.5f };
+            f32 maxScale { 1.0f };
+            f64 headroom { 0.1 };
+            f32 maxStepUp { 0.02f };
+        };
+
+    public:
+        DynamicResolution(const Config& config);
+
+        inline bool IsEnabled() const { return m_Config.enabled; }
+        inline f32 GetScale() const { return m_Scale; }
+        inline f64 GetSmoothedGpuMs() const { return m_GpuMs; }
+
+        void Update(f64 gpuMs);
+
+        VkExtent2D GetRenderExtent(VkExtent2D outputExtent) const;
+        VkExtent2D GetMaxExtent(VkExtent2D outputExtent) const;
+
+    private:
+        static VkExtent2D ScaleExtent(VkExtent2D extent, f32 scale);
+
+    private:
+        Config m_Config;
+
+        f32 m_Scale { 1.0f };
+        f64 m_GpuMs { 0.0 };
+    };
+
+}
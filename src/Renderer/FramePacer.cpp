@@ -0,0 +1,91 @@
+#include "FramePacer.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#include "Core/Profiler.hpp"
+
+namespace Renderer {
+
+    FramePacer::FramePacer(const Config& config)
+        : m_Config(config)
+    {
+        m_Config.maxQueuedFrames = std::max(m_Config.maxQueuedFrames, 1u);
+    }
+
+    void FramePacer::QueuePresent(u64 presentId, i64 inputTimestampNs)
+    {
+        m_QueuedPresents.push_back(QueuedPresent { presentId, inputTimestampNs });
+    }
+
+    bool FramePacer::HasExcessQueuedPresents() const
+    {
+        return m_QueuedPresents.size() > m_Config.maxQueuedFrames;
+    }
+
+    FramePacer::QueuedPresent FramePacer::PopOldestPresent()
+    {
+        QueuedPresent present = m_QueuedPresents.front();
+        m_QueuedPresents.pop_front();
+        return present;
+    }
+
+    void FramePacer::RecordPresented(i64 inputTimestampNs, i64 presentedNs)
+    {
+        if (m_LastPresentedNs != 0)
+            m_PresentIntervalNs = Smooth(m_PresentIntervalNs, static_cast<f64>(presentedNs - m_LastPresentedNs));
+        m_LastPresentedNs = presentedNs;
+
+        if (m_FrameStartNs != 0)
+            m_FrameDurationNs = Smooth(m_FrameDurationNs, static_cast<f64>(presentedNs - m_FrameStartNs));
+
+        if (inputTimestampNs == 0)
+            return;
+
+        f64 latencyMs = static_cast<f64>(presentedNs - inputTimestampNs) / 1'000'000.0;
+
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        m_Latency.lastMs = latencyMs;
+        m_Latency.minMs = m_Latency.sampleCount == 0 ? latencyMs : std::min(m_Latency.minMs, latencyMs);
+        m_Latency.maxMs = std::max(m_Latency.maxMs, latencyMs);
+        m_Latency.sampleCount++;
+        m_LatencySumMs += latencyMs;
+        m_Latency.avgMs = m_LatencySumMs / static_cast<f64>(m_Latency.sampleCount);
+    }
+
+    void FramePacer::RecordFrameStart(i64 frameStartNs)
+    {
+        m_FrameStartNs = frameStartNs;
+    }
+
+    void FramePacer::Throttle()
+    {
+        if (!m_Config.enabled || m_LastPresentedNs == 0)
+            return;
+
+        // Start the next frame just late enough that it finishes as the next
+        // present slot opens, instead of queueing behind the current one.
+        f64 slackNs = m_PresentIntervalNs - m_FrameDurationNs - m_Config.marginMs * 1'000'000.0;
+        i64 wakeNs = m_LastPresentedNs + static_cast<i64>(slackNs);
+        i64 nowNs = Profiler::Now();
+
+        if (slackNs <= 0.0 || wakeNs <= nowNs)
+            return;
+
+        PROFILE_SCOPE("FramePacer::Throttle")
+        std::this_thread::sleep_for(std::chrono::nanoseconds(wakeNs - nowNs));
+    }
+
+    FramePacer::LatencyStats FramePacer::GetLatencyStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        return m_Latency;
+    }
+
+    f64 FramePacer::Smooth(f64 average, f64 sample)
+    {
+        static constexpr f64 weight = 0.1;
+        return average == 0.0 ? sample : average + (sample - average) * weight;
+    }
+
+}
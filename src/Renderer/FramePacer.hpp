@@ -0,0 +1,68 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+#include "Core/Types.hpp"
+
+namespace Renderer {
+
+    class FramePacer
+    {
+    public:
+        struct Config
+        {
+            bool enabled { false };
+            u32 maxQueuedFrames { 1 };
+            f64 marginMs { 1.0 };
+        };
+
+        struct LatencyStats
+        {
+            f64 lastMs { 0.0 };
+            f64 avgMs { 0.0 };
+            f64 minMs { 0.0 };
+            f64 maxMs { 0.0 };
+            u64 sampleCount { 0 };
+        };
+
+        struct QueuedPresent
+        {
+            u64 presentId { 0 };
+            i64 inputTimestampNs { 0 };
+        };
+
+    public:
+        FramePacer(const Config& config);
+
+        inline bool IsEnabled() const { return m_Config.enabled; }
+
+        void QueuePresent(u64 presentId, i64 inputTimestampNs);
+        bool HasExcessQueuedPresents() const;
+        QueuedPresent PopOldestPresent();
+
+        void RecordPresented(i64 inputTimestampNs, i64 presentedNs);
+        void RecordFrameStart(i64 frameStartNs);
+        void Throttle();
+
+        LatencyStats GetLatencyStats() const;
+
+    private:
+        static f64 Smooth(f64 average, f64 sample);
+
+    private:
+        Config m_Config;
+
+        std::deque<QueuedPresent> m_QueuedPresents;
+
+        i64 m_FrameStartNs { 0 };
+        i64 m_LastPresentedNs { 0 };
+        f64 m_PresentIntervalNs { 0.0 };
+        f64 m_FrameDurationNs { 0.0 };
+
+        mutable std::mutex m_StatsMutex;
+        LatencyStats m_Latency;
+        f64 m_LatencySumMs { 0.0 };
+    };
+
+}
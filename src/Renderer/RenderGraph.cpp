@@ -2,10 +2,52 @@
 
 #include <queue>
 #include <set>
+#include <optional>
 #include <algorithm>
+#include <cassert>
+
+#include "Core/Profiler.hpp"
 
 namespace Renderer {
 
+#ifndef NDEBUG
+    namespace {
+
+        bool IsSamePlan(const ExecutionPlan& a, const ExecutionPlan& b)
+        {
+            auto samePasses = [](const std::vector<ExecutionPass>& x, const std::vector<ExecutionPass>& y) {
+                return std::equal(x.begin(), x.end(), y.begin(), y.end(), [](const ExecutionPass& p, const ExecutionPass& q) {
+                    return p.pass == q.pass;
+                });
+            };
+
+            auto sameUses = [](const std::vector<Resource>& x, const std::vector<Resource>& y) {
+                return std::equal(x.begin(), x.end(), y.begin(), y.end(), [](const Resource& r, const Resource& q) {
+                    return r.firstUse == q.firstUse && r.lastUse == q.lastUse;
+                });
+            };
+
+            auto sameBarriers = [](const std::vector<Barrier>& x, const std::vector<Barrier>& y) {
+                return std::equal(x.begin(), x.end(), y.begin(), y.end(), [](const Barrier& p, const Barrier& q) {
+                    return p.srcPass == q.srcPass && p.dstPass == q.dstPass && p.resource == q.resource
+                        && p.oldLayout == q.oldLayout && p.newLayout == q.newLayout
+                        && p.srcStageMask == q.srcStageMask && p.dstStageMask == q.dstStageMask
+                        && p.srcAccessMask == q.srcAccessMask && p.dstAccessMask == q.dstAccessMask
+                        && p.srcQueueFamily == q.srcQueueFamily && p.dstQueueFamily == q.dstQueueFamily;
+                });
+            };
+
+            return samePasses(a.orderedPasses, b.orderedPasses)
+                && samePasses(a.culledPasses, b.culledPasses)
+                && a.edges == b.edges
+                && sameUses(a.resources, b.resources)
+                && sameBarriers(a.barriers, b.barriers)
+                && a.allocationIdPerResource == b.allocationIdPerResource;
+        }
+
+    }
+#endif
+
     ResourceHandle RenderGraph::CreateImage(const std::string& name, ImageDesc desc, bool imported)
     {
         m_Resources.push_back(Resource {
@@ -14,6 +56,8 @@ namespace Renderer {
             .imageDesc = desc,
             .imported = imported
         });
+        m_ResourceUses.emplace_back();
+
         return static_cast<ResourceHandle>(m_Resources.size() - 1);
     }
 
@@ -23,27 +67,102 @@ namespace Renderer {
         pass.name = name;
         pass.record = record;
 
-        PassBuilder builder(pass);
-        setup(builder);
+        return InsertPass(std::move(pass), setup);
+    }
+
+    PassHandle RenderGraph::InsertPass(Pass pass, const std::function<void(class RenderGraph::PassBuilder&)>& setup)
+    {
+        {
+            PassBuilder builder(pass);
+            setup(builder);
+        }
+
         m_Passes.push_back(std::move(pass));
+        PassHandle handle = static_cast<PassHandle>(m_Passes.size() - 1);
+
+        for (const auto& ai : m_Passes.back().accesses)
+            m_ResourceUses.at(ai.resource).push_back({handle, ai});
+
+        m_DirtyPasses.push_back(handle);
+        m_LivePassCount++;
 
-        return static_cast<PassHandle>(m_Passes.size() - 1);
+        return handle;
     }
 
-    ExecutionPlan RenderGraph::Compile()
+    void RenderGraph::RemovePass(PassHandle handle)
     {
-        std::vector<std::vector<std::pair<PassHandle, AccessInfo>>> resourceUses(m_Resources.size());
-        for (PassHandle pi = 0; pi < m_Passes.size(); ++pi) {
-            for (const auto& ai : m_Passes[pi].accesses) {
-                resourceUses.at(ai.resource).push_back({pi, ai});
-            }
+        Pass& pass = m_Passes.at(handle);
+        if (pass.removed)
+            return;
+
+        pass.removed = true;
+        m_LivePassCount--;
+
+        for (const auto& ai : pass.accesses) {
+            auto& uses = m_ResourceUses.at(ai.resource);
+            std::erase_if(uses, [handle](const auto& pr) { return pr.first == handle; });
+        }
+
+        m_DirtyPasses.push_back(handle);
+    }
+
+    ExecutionPlan RenderGraph::Compile(ScheduleMode mode)
+    {
+        bool incremental = CanCompileIncrementally(mode);
+        ExecutionPlan plan = Compile(mode, incremental);
+
+#ifndef NDEBUG
+        // Debug builds check every incremental plan against a full compile,
+        // which leaves the cache in the same state.
+        if (incremental) {
+            ExecutionPlan full = CompileFull(mode);
+            assert(IsSamePlan(plan, full) && "Incremental render graph compile diverged from a full compile");
+            m_LastCompileIncremental = true;
+        }
+#endif
+
+        return plan;
+    }
+
+    ExecutionPlan RenderGraph::CompileFull(ScheduleMode mode)
+    {
+        return Compile(mode, false);
+    }
+
+    bool RenderGraph::HasImportedUses() const
+    {
+        for (ResourceHandle r = 0; r < m_Resources.size(); ++r) {
+            if (m_Resources[r].imported && !m_ResourceUses[r].empty())
+                return true;
         }
 
-        std::vector<char> passAlive(m_Passes.size(), 0);
+        return false;
+    }
+
+    bool RenderGraph::CanCompileIncrementally(ScheduleMode mode) const
+    {
+        if (!m_Cache.valid || m_Cache.mode != mode)
+            return false;
+
+        // Culling switches between seeded and keep-everything on whether any
+        // imported resource is used, which flips the liveness of every pass.
+        if (m_Cache.hasImportedUses != HasImportedUses())
+            return false;
+
+        // Past a quarter of the graph the cone walks cost more than they save.
+        // Removed passes stay in m_Passes, so only live ones are counted.
+        return m_DirtyPasses.size() * 4 <= m_LivePassCount;
+    }
+
+    void RenderGraph::ComputeLiveness()
+    {
+        auto& passAlive = m_Cache.passAlive;
+        passAlive.assign(m_Passes.size(), 0);
+
         std::queue<PassHandle> q;
         for (ResourceHandle r = 0; r < m_Resources.size(); ++r) {
             if (m_Resources[r].imported) {
-                for (auto& pr : resourceUses[r]) {
+                for (auto& pr : m_ResourceUses[r]) {
                     if (!passAlive.at(pr.first)) {
                         passAlive.at(pr.first) = 1;
                         q.push(pr.first);
@@ -53,110 +172,294 @@ namespace Renderer {
         }
 
         if (q.empty()) {
-            for (usize i = 0; i < passAlive.size(); ++i) passAlive[i] = 1;
-        } else {
-            while (!q.empty()) {
-                auto pIdx = q.front();
-                q.pop();
+            for (PassHandle i = 0; i < m_Passes.size(); ++i)
+                passAlive[i] = !m_Passes[i].removed;
+            return;
+        }
 
-                for (const auto& ai : m_Passes.at(pIdx).accesses) {
-                    auto r = ai.resource;
+        while (!q.empty()) {
+            auto pIdx = q.front();
+            q.pop();
 
-                    for (auto& pr : resourceUses.at(r)) {
-                        auto otherPass = pr.first;
-                        bool isWrite = (pr.second.type == AccessType::Write || pr.second.type == AccessType::ReadWrite);
+            for (const auto& ai : m_Passes.at(pIdx).accesses) {
+                for (auto& pr : m_ResourceUses.at(ai.resource)) {
+                    auto otherPass = pr.first;
+                    bool isWrite = (pr.second.type == AccessType::Write || pr.second.type == AccessType::ReadWrite);
 
-                        if (otherPass < pIdx && !passAlive.at(otherPass) && isWrite) {
-                            passAlive.at(otherPass) = 1;
-                            q.push(otherPass);
-                        }
+                    if (otherPass < pIdx && !passAlive.at(otherPass) && isWrite) {
+                        passAlive.at(otherPass) = 1;
+                        q.push(otherPass);
                     }
                 }
             }
         }
+    }
 
-        std::vector<PassHandle> alivePasses;
-        alivePasses.reserve(m_Passes.size());
-        std::vector<i32> passRemap(m_Passes.size(), -1);
-        for (PassHandle i = 0; i < m_Passes.size(); ++i) {
-            if (passAlive[i]) {
-                passRemap[i] = static_cast<i32>(alivePasses.size());
-                alivePasses.push_back(i);
-            }
+    void RenderGraph::PatchLiveness(std::vector<char>& touchedResources)
+    {
+        auto& passAlive = m_Cache.passAlive;
+        std::vector<char> previousAlive = passAlive;
+        previousAlive.resize(m_Passes.size(), 0);
+        passAlive.resize(m_Passes.size(), 0);
+
+        for (PassHandle d : m_DirtyPasses) {
+            for (const auto& ai : m_Passes.at(d).accesses)
+                touchedResources.at(ai.resource) = 1;
         }
 
-        if (alivePasses.empty()) return {};
+        if (!m_Cache.hasImportedUses) {
+            for (PassHandle d : m_DirtyPasses)
+                passAlive.at(d) = !m_Passes.at(d).removed;
+            return;
+        }
 
-        usize N = alivePasses.size();
-        std::vector<std::vector<i32>> adj(N);
-        std::vector<i32> indeg(N, 0);
-        std::set<std::pair<i32, i32>> edges;
+        // Only passes upstream of a changed pass can change liveness, so the
+        // seeded flood fill is rerun on that cone alone.
+        std::vector<char> inCone(m_Passes.size(), 0);
+        std::vector<PassHandle> cone;
+        std::queue<PassHandle> q;
 
-        for (ResourceHandle r = 0; r < m_Resources.size(); ++r) {
-            std::vector<std::pair<PassHandle, AccessInfo>> uses;
+        for (PassHandle d : m_DirtyPasses) {
+            passAlive.at(d) = 0;
+            q.push(d);
+
+            if (!m_Passes.at(d).removed && !inCone.at(d)) {
+                inCone.at(d) = 1;
+                cone.push_back(d);
+            }
+        }
+
+        while (!q.empty()) {
+            auto pIdx = q.front();
+            q.pop();
 
-            for (auto& pr : resourceUses.at(r)) {
-                if (passRemap.at(pr.first) >= 0)
-                    uses.push_back(pr);
+            for (const auto& ai : m_Passes.at(pIdx).accesses) {
+                for (auto& pr : m_ResourceUses.at(ai.resource)) {
+                    bool isWrite = pr.second.type != AccessType::Read;
+
+                    if (pr.first < pIdx && isWrite && !inCone.at(pr.first)) {
+                        inCone.at(pr.first) = 1;
+                        cone.push_back(pr.first);
+                        q.push(pr.first);
+                    }
+                }
             }
+        }
 
-            if (uses.empty()) continue;
-            std::sort(uses.begin(), uses.end(), [](auto& a, auto& b) {
-                return a.first < b.first;
-            });
+        for (PassHandle p : cone)
+            passAlive.at(p) = 0;
 
-            i32 lastWriterRemappedIdx = -1;
-            std::vector<i32> lastReadersRemappedIdx;
+        for (PassHandle p : cone) {
+            bool keep = false;
 
-            for (auto& pr : uses) {
-                i32 remapped = passRemap.at(pr.first);
-                bool isWrite = (pr.second.type != AccessType::Read);
+            for (const auto& ai : m_Passes.at(p).accesses) {
+                if (m_Resources.at(ai.resource).imported) {
+                    keep = true;
+                    break;
+                }
 
-                if (isWrite) {
-                    if (lastWriterRemappedIdx != -1 && lastWriterRemappedIdx != remapped)
-                        edges.insert({lastWriterRemappedIdx, remapped});
+                if (ai.type == AccessType::Read)
+                    continue;
 
-                    for (i32 readerIdx : lastReadersRemappedIdx) {
-                        if (readerIdx != remapped)
-                            edges.insert({readerIdx, remapped});
+                for (auto& pr : m_ResourceUses.at(ai.resource)) {
+                    if (pr.first > p && !inCone.at(pr.first) && passAlive.at(pr.first)) {
+                        keep = true;
+                        break;
                     }
+                }
 
-                    lastReadersRemappedIdx.clear();
-                    lastWriterRemappedIdx = remapped;
-                } else {
-                    if (lastWriterRemappedIdx != -1 && lastWriterRemappedIdx != remapped)
-                        edges.insert({lastWriterRemappedIdx, remapped});
+                if (keep)
+                    break;
+            }
+
+            if (keep) {
+                passAlive.at(p) = 1;
+                q.push(p);
+            }
+        }
+
+        while (!q.empty()) {
+            auto pIdx = q.front();
+            q.pop();
 
-                    lastReadersRemappedIdx.push_back(remapped);
+            for (const auto& ai : m_Passes.at(pIdx).accesses) {
+                for (auto& pr : m_ResourceUses.at(ai.resource)) {
+                    bool isWrite = pr.second.type != AccessType::Read;
+
+                    if (pr.first < pIdx && isWrite && !passAlive.at(pr.first)) {
+                        passAlive.at(pr.first) = 1;
+                        q.push(pr.first);
+                    }
                 }
             }
         }
 
-        for (const auto& edge : edges) {
-            adj.at(edge.first).push_back(edge.second);
-            indeg[edge.second]++;
+        for (PassHandle p : cone) {
+            if (passAlive.at(p) != previousAlive.at(p)) {
+                for (const auto& ai : m_Passes.at(p).accesses)
+                    touchedResources.at(ai.resource) = 1;
+            }
         }
+    }
 
-        std::queue<i32> kahn;
-        for (i32 i = 0; i < static_cast<i32>(N); ++i) {
-            if (indeg.at(i) == 0)
-                kahn.push(i);
+    void RenderGraph::BuildResourceEdges(ResourceHandle resource)
+    {
+        auto& edges = m_Cache.resourceEdges.at(resource);
+        edges.clear();
+
+        PassHandle lastWriter = std::numeric_limits<u32>::max();
+        std::vector<PassHandle> lastReaders;
+
+        for (auto& pr : m_ResourceUses.at(resource)) {
+            if (!m_Cache.passAlive.at(pr.first))
+                continue;
+
+            bool isWrite = (pr.second.type != AccessType::Read);
+
+            if (isWrite) {
+                if (lastWriter != std::numeric_limits<u32>::max() && lastWriter != pr.first)
+                    edges.push_back({lastWriter, pr.first});
+
+                for (PassHandle reader : lastReaders) {
+                    if (reader != pr.first)
+                        edges.push_back({reader, pr.first});
+                }
+
+                lastReaders.clear();
+                lastWriter = pr.first;
+            } else {
+                if (lastWriter != std::numeric_limits<u32>::max() && lastWriter != pr.first)
+                    edges.push_back({lastWriter, pr.first});
+
+                lastReaders.push_back(pr.first);
+            }
         }
+    }
 
-        std::vector<i32> topo;
-        topo.reserve(N);
-        while (!kahn.empty()) {
-            i32 v = kahn.front();
-            kahn.pop();
-            topo.push_back(v);
+    void RenderGraph::BuildResourceBarriers(ResourceHandle resource, const std::vector<i32>& passPosition)
+    {
+        std::vector<std::pair<i32, AccessInfo>> uses;
+        for (auto& pr : m_ResourceUses.at(resource)) {
+            if (m_Cache.passAlive.at(pr.first))
+                uses.push_back({passPosition.at(pr.first), pr.second});
+        }
 
-            for (i32 nx : adj.at(v)) {
-                indeg[nx]--;
-                if (indeg.at(nx) == 0)
-                    kahn.push(nx);
+        std::sort(uses.begin(), uses.end(), [](auto& a, auto& b) {
+            return a.first < b.first;
+        });
+
+        auto& users = m_Cache.resourceUsers.at(resource);
+        auto& barriers = m_Cache.resourceBarriers.at(resource);
+        users.clear();
+        barriers.clear();
+
+        if (uses.empty()) return;
+
+        const auto& execOrder = m_Cache.execOrder;
+        for (auto& u : uses)
+            users.push_back(execOrder.at(u.first));
+
+        // Frames in flight reuse the same images, so the first use waits for
+        // the last use of the previous frame instead of for nothing.
+        {
+            auto& u = uses.front();
+            auto& last = uses.back();
+            barriers.push_back(Barrier {
+                .srcPass = std::numeric_limits<u32>::max(),
+                .dstPass = execOrder.at(u.first),
+                .resource = resource,
+                .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .newLayout = u.second.layout,
+                .srcStageMask = last.second.stage,
+                .dstStageMask = u.second.stage,
+                .srcAccessMask = last.second.type != AccessType::Read ? last.second.accessMask : 0,
+                .dstAccessMask = u.second.accessMask
+            });
+        }
+
+        for (usize i = 0; i + 1 < uses.size(); ++i) {
+            auto& cur = uses[i];
+            auto& nxt = uses[i+1];
+
+            if (cur.first == nxt.first) continue;
+
+            bool curIsWrite = cur.second.type != AccessType::Read;
+            bool nxtIsWrite = nxt.second.type != AccessType::Read;
+
+            if (!curIsWrite && !nxtIsWrite && cur.second.layout == nxt.second.layout)
+                continue;
+
+            barriers.push_back(Barrier {
+                .srcPass = execOrder.at(cur.first),
+                .dstPass = execOrder.at(nxt.first),
+                .resource = resource,
+                .oldLayout = cur.second.layout,
+                .newLayout = nxt.second.layout,
+                .srcStageMask = cur.second.stage,
+                .dstStageMask = nxt.second.stage,
+                .srcAccessMask = cur.second.accessMask,
+                .dstAccessMask = nxt.second.accessMask
+            });
+        }
+    }
+
+    ExecutionPlan RenderGraph::Compile(ScheduleMode mode, bool incremental)
+    {
+        PROFILE_SCOPE("RenderGraph::Compile")
+
+        m_LastCompileIncremental = incremental;
+
+        std::vector<char> touched(m_Resources.size(), incremental ? 0 : 1);
+        std::vector<char> previousAlive = m_Cache.passAlive;
+        std::vector<PassHandle> previousOrder = m_Cache.execOrder;
+
+        m_Cache.resourceEdges.resize(m_Resources.size());
+        m_Cache.resourceUsers.resize(m_Resources.size());
+        m_Cache.resourceBarriers.resize(m_Resources.size());
+
+        if (incremental) {
+            PatchLiveness(touched);
+        } else {
+            m_Cache.hasImportedUses = HasImportedUses();
+            ComputeLiveness();
+        }
+
+        m_Cache.valid = false;
+        m_Cache.mode = mode;
+        m_DirtyPasses.clear();
+
+        const auto& passAlive = m_Cache.passAlive;
+
+        std::vector<PassHandle> alivePasses;
+        alivePasses.reserve(m_Passes.size());
+        std::vector<i32> passRemap(m_Passes.size(), -1);
+        for (PassHandle i = 0; i < m_Passes.size(); ++i) {
+            if (passAlive[i]) {
+                passRemap[i] = static_cast<i32>(alivePasses.size());
+                alivePasses.push_back(i);
             }
         }
 
+        if (alivePasses.empty()) return {};
+
+        usize N = alivePasses.size();
+        std::vector<std::vector<i32>> adj(N);
+        std::set<std::pair<i32, i32>> edges;
+
+        for (ResourceHandle r = 0; r < m_Resources.size(); ++r) {
+            if (touched[r])
+                BuildResourceEdges(r);
+
+            for (const auto& edge : m_Cache.resourceEdges[r])
+                edges.insert({passRemap.at(edge.first), passRemap.at(edge.second)});
+        }
+
+        for (const auto& edge : edges) {
+            adj.at(edge.first).push_back(edge.second);
+        }
+
+        std::vector<i32> topo = SchedulePasses(alivePasses, adj, mode);
+
         if (topo.size() != N) {
             LOG_ERROR("[RenderGraph] Cycle detected in pass dependencies");
             return {};
@@ -167,24 +470,50 @@ namespace Renderer {
         for (i32 idx : topo)
             execOrder.push_back(alivePasses.at(idx));
 
-        for (auto& res : m_Resources) {
-            res.firstUse = -1;
-            res.lastUse = -1;
-        }
+        if (incremental) {
+            // Untouched resources keep their cached users and barriers only if
+            // every pass that stayed alive kept its relative position.
+            auto stable = [&](PassHandle p) {
+                return p < previousAlive.size() && previousAlive[p] && passAlive[p];
+            };
 
-        for (i32 i = 0; i < static_cast<i32>(execOrder.size()); ++i) {
-            PassHandle p = execOrder[i];
+            auto oldIt = previousOrder.begin();
+            auto newIt = execOrder.begin();
+            bool sequencePreserved = true;
 
-            for (const auto& ai : m_Passes.at(p).accesses) {
-                auto r = ai.resource;
+            while (sequencePreserved) {
+                oldIt = std::find_if(oldIt, previousOrder.end(), stable);
+                newIt = std::find_if(newIt, execOrder.end(), stable);
 
-                if (m_Resources[r].firstUse == -1)
-                    m_Resources[r].firstUse = i;
+                if (oldIt == previousOrder.end() || newIt == execOrder.end()) {
+                    sequencePreserved = (oldIt == previousOrder.end()) && (newIt == execOrder.end());
+                    break;
+                }
 
-                m_Resources[r].lastUse = i;
+                sequencePreserved = (*oldIt++ == *newIt++);
             }
+
+            if (!sequencePreserved)
+                std::fill(touched.begin(), touched.end(), 1);
         }
 
+        m_Cache.execOrder = execOrder;
+
+        std::vector<i32> passPosition(m_Passes.size(), -1);
+        for (i32 i = 0; i < static_cast<i32>(execOrder.size()); ++i)
+            passPosition[execOrder[i]] = i;
+
+        for (ResourceHandle r = 0; r < m_Resources.size(); ++r) {
+            if (touched[r])
+                BuildResourceBarriers(r, passPosition);
+
+            const auto& users = m_Cache.resourceUsers[r];
+            m_Resources[r].firstUse = users.empty() ? -1 : passPosition.at(users.front());
+            m_Resources[r].lastUse = users.empty() ? -1 : passPosition.at(users.back());
+        }
+
+        m_Cache.valid = true;
+
         i32 totalAllocs = 0;
         std::vector<i32> allocId(m_Resources.size(), -1);
 
@@ -247,78 +576,177 @@ namespace Renderer {
         totalAllocs = aliasedPoolSize + nextNonAliasedId;
         (void)totalAllocs;
 
-        std::vector<Barrier> barriers;
-        for (ResourceHandle r = 0; r < m_Resources.size(); ++r) {
-            std::vector<std::pair<i32, AccessInfo>> uses;
+        ExecutionPlan plan;
+        plan.resources = m_Resources;
+        plan.allocationIdPerResource = allocId;
 
-            for (i32 pos = 0; pos < static_cast<i32>(execOrder.size()); ++pos) {
-                for (const auto& ai : m_Passes[execOrder[pos]].accesses) {
-                    if (ai.resource == r)
-                        uses.push_back({pos, ai});
-                }
-            }
+        for (i32 i = 0; i < static_cast<i32>(execOrder.size()); ++i) {
+            plan.orderedPasses.push_back({
+                .pass = execOrder[i],
+                .name = m_Passes[execOrder[i]].name
+            });
+        }
 
-            if (uses.empty()) continue;
-
-            {
-                auto& u = uses.front();
-                barriers.push_back(Barrier {
-                    .srcPass = std::numeric_limits<u32>::max(),
-                    .dstPass = static_cast<PassHandle>(u.first),
-                    .resource = r,
-                    .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-                    .newLayout = u.second.layout,
-                    .srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                    .dstStageMask = u.second.stage,
-                    .srcAccessMask = 0,
-                    .dstAccessMask = u.second.accessMask
+        for (PassHandle i = 0; i < m_Passes.size(); ++i) {
+            if (!passAlive[i] && !m_Passes[i].removed) {
+                plan.culledPasses.push_back({
+                    .pass = i,
+                    .name = m_Passes[i].name
                 });
             }
+        }
 
-            for (usize i = 0; i + 1 < uses.size(); ++i) {
-                auto& cur = uses[i];
-                auto& nxt = uses[i+1];
+        plan.edges.reserve(edges.size());
+        for (const auto& edge : edges)
+            plan.edges.push_back({alivePasses.at(edge.first), alivePasses.at(edge.second)});
 
-                if (cur.first == nxt.first) continue;
+        std::set<PassHandle> barrierBatches;
+        for (const auto& resourceBarriers : m_Cache.resourceBarriers) {
+            for (const auto& b : resourceBarriers) {
+                plan.barriers.push_back(b);
+                barrierBatches.insert(b.dstPass);
+            }
+        }
 
-                bool curIsWrite = cur.second.type != AccessType::Read;
-                bool nxtIsWrite = nxt.second.type != AccessType::Read;
+        std::vector<i32> pathLength(N, 1);
+        std::vector<i32> pathPrev(N, -1);
+        for (i32 v : topo) {
+            for (i32 nx : adj.at(v)) {
+                if (pathLength[v] + 1 > pathLength[nx]) {
+                    pathLength[nx] = pathLength[v] + 1;
+                    pathPrev[nx] = v;
+                }
+            }
+        }
 
-                if (!curIsWrite && !nxtIsWrite && cur.second.layout == nxt.second.layout)
-                    continue;
+        i32 pathEnd = static_cast<i32>(std::distance(pathLength.begin(), std::max_element(pathLength.begin(), pathLength.end())));
+        for (i32 v = pathEnd; v != -1; v = pathPrev[v])
+            plan.stats.criticalPath.push_back(alivePasses.at(v));
+        std::reverse(plan.stats.criticalPath.begin(), plan.stats.criticalPath.end());
 
-                barriers.push_back(Barrier {
-                    .srcPass = static_cast<PassHandle>(cur.first),
-                    .dstPass = static_cast<PassHandle>(nxt.first),
-                    .resource = r,
-                    .oldLayout = cur.second.layout,
-                    .newLayout = nxt.second.layout,
-                    .srcStageMask = cur.second.stage,
-                    .dstStageMask = nxt.second.stage,
-                    .srcAccessMask = cur.second.accessMask,
-                    .dstAccessMask = nxt.second.accessMask
-                });
+        plan.stats.barrierCount = static_cast<u32>(plan.barriers.size());
+        plan.stats.barrierBatchCount = static_cast<u32>(barrierBatches.size());
+        plan.stats.criticalPathLength = static_cast<u32>(plan.stats.criticalPath.size());
+
+        return plan;
+    }
+
+    std::vector<i32> RenderGraph::SchedulePasses(const std::vector<PassHandle>& alivePasses, const std::vector<std::vector<i32>>& adj, ScheduleMode mode) const
+    {
+        usize N = alivePasses.size();
+
+        std::vector<i32> indeg(N, 0);
+        for (const auto& successors : adj) {
+            for (i32 nx : successors)
+                indeg[nx]++;
+        }
+
+        std::queue<i32> kahn;
+        for (i32 i = 0; i < static_cast<i32>(N); ++i) {
+            if (indeg.at(i) == 0)
+                kahn.push(i);
+        }
+
+        std::vector<i32> topo;
+        topo.reserve(N);
+        while (!kahn.empty()) {
+            i32 v = kahn.front();
+            kahn.pop();
+            topo.push_back(v);
+
+            for (i32 nx : adj.at(v)) {
+                indeg[nx]--;
+                if (indeg.at(nx) == 0)
+                    kahn.push(nx);
             }
         }
 
-        ExecutionPlan plan;
-        plan.resources = m_Resources;
-        plan.allocationIdPerResource = allocId;
+        if (mode == ScheduleMode::Naive || topo.size() != N)
+            return topo;
 
-        for (i32 i = 0; i < static_cast<i32>(execOrder.size()); ++i) {
-            plan.orderedPasses.push_back({
-                .pass = execOrder[i],
-                .name = m_Passes[execOrder[i]].name
-            });
+        // Longest chain of dependent passes starting at each pass. Passes that gate
+        // long chains are scheduled first so their consumers can be pushed back.
+        std::vector<i64> height(N, 1);
+        for (auto it = topo.rbegin(); it != topo.rend(); ++it) {
+            for (i32 nx : adj.at(*it))
+                height[*it] = std::max(height[*it], height[nx] + 1);
         }
 
-        for (auto& b : barriers) {
-            if (b.srcPass != std::numeric_limits<u32>::max()) b.srcPass = execOrder[b.srcPass];
-            if (b.dstPass != std::numeric_limits<u32>::max()) b.dstPass = execOrder[b.dstPass];
-            plan.barriers.push_back(b);
+        static constexpr i64 s_HeightWeight = 4;
+        static constexpr i64 s_BarrierWeight = 3;
+        static constexpr i64 s_DirectDependencyWeight = 2;
+        static constexpr i64 s_QueueInterleaveWeight = 1;
+
+        for (const auto& successors : adj) {
+            for (i32 nx : successors)
+                indeg[nx]++;
         }
 
-        return plan;
+        std::vector<i32> ready;
+        for (i32 i = 0; i < static_cast<i32>(N); ++i) {
+            if (indeg.at(i) == 0)
+                ready.push_back(i);
+        }
+
+        std::vector<std::optional<AccessInfo>> lastAccess(m_Resources.size());
+
+        std::vector<i32> order;
+        order.reserve(N);
+        i32 prev = -1;
+
+        while (!ready.empty()) {
+            usize bestSlot = 0;
+            i64 bestScore = std::numeric_limits<i64>::min();
+
+            for (usize slot = 0; slot < ready.size(); ++slot) {
+                i32 candidate = ready[slot];
+                const Pass& pass = m_Passes.at(alivePasses.at(candidate));
+
+                i64 barriersNeeded = 0;
+                for (const auto& ai : pass.accesses) {
+                    const auto& last = lastAccess.at(ai.resource);
+                    if (!last.has_value())
+                        continue;
+
+                    if (last->type == AccessType::Read && ai.type == AccessType::Read && last->layout == ai.layout)
+                        continue;
+
+                    barriersNeeded++;
+                }
+
+                i64 score = height[candidate] * s_HeightWeight - barriersNeeded * s_BarrierWeight;
+
+                if (prev != -1) {
+                    const auto& prevSuccessors = adj.at(prev);
+                    if (std::find(prevSuccessors.begin(), prevSuccessors.end(), candidate) != prevSuccessors.end())
+                        score -= s_DirectDependencyWeight;
+
+                    if (pass.asyncCompute != m_Passes.at(alivePasses.at(prev)).asyncCompute)
+                        score += s_QueueInterleaveWeight;
+                }
+
+                if (score > bestScore || (score == bestScore && candidate < ready[bestSlot])) {
+                    bestScore = score;
+                    bestSlot = slot;
+                }
+            }
+
+            i32 v = ready[bestSlot];
+            ready.erase(ready.begin() + static_cast<std::ptrdiff_t>(bestSlot));
+            order.push_back(v);
+            prev = v;
+
+            for (const auto& ai : m_Passes.at(alivePasses.at(v)).accesses)
+                lastAccess.at(ai.resource) = ai;
+
+            for (i32 nx : adj.at(v)) {
+                indeg[nx]--;
+                if (indeg.at(nx) == 0)
+                    ready.push_back(nx);
+            }
+        }
+
+        return order;
     }
 
 }
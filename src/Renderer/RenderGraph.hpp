@@ -23,6 +23,12 @@ namespace Renderer {
         ReadWrite
     };
 
+    enum class ScheduleMode
+    {
+        Naive,
+        Optimized
+    };
+
     struct ImageDesc
     {
         u32 width { 0 };
@@ -56,6 +62,8 @@ namespace Renderer {
     {
         std::string name;
         std::vector<AccessInfo> accesses;
+        bool asyncCompute { false };
+        bool removed { false };
         std::function<void(VkCommandBuffer, const std::unordered_map<ResourceHandle, VkImageView>&)> record;
     };
 
@@ -80,12 +88,23 @@ namespace Renderer {
         std::string name;
     };
 
+    struct ScheduleStats
+    {
+        u32 barrierCount { 0 };
+        u32 barrierBatchCount { 0 };
+        u32 criticalPathLength { 0 };
+        std::vector<PassHandle> criticalPath;
+    };
+
     struct ExecutionPlan
     {
         std::vector<ExecutionPass> orderedPasses;
+        std::vector<ExecutionPass> culledPasses;
+        std::vector<std::pair<PassHandle, PassHandle>> edges;
         std::vector<Resource> resources;
         std::vector<Barrier> barriers;
         std::vector<i32> allocationIdPerResource;
+        ScheduleStats stats;
     };
 
     class RenderGraph
@@ -138,6 +157,11 @@ namespace Renderer {
                 });
             }
 
+            void AllowAsyncCompute(bool allow = true)
+            {
+                m_Pass.asyncCompute = allow;
+            }
+
         private:
             void AddAccess(AccessInfo ai)
             {
@@ -176,13 +200,59 @@ namespace Renderer {
             return m_Passes.at(handle);
         }
 
+        inline usize GetResourceCount() const { return m_Resources.size(); }
+        inline usize GetPassCount() const { return m_Passes.size(); }
+
         ResourceHandle CreateImage(const std::string& name, ImageDesc desc, bool imported = false);
         PassHandle AddPass(const std::string& name, std::function<void(class RenderGraph::PassBuilder&)> setup, std::function<void(VkCommandBuffer, const std::unordered_map<ResourceHandle, VkImageView>&)> record = {});
-        ExecutionPlan Compile();
+        void RemovePass(PassHandle handle);
+
+        ExecutionPlan Compile(ScheduleMode mode = ScheduleMode::Naive);
+        ExecutionPlan CompileFull(ScheduleMode mode = ScheduleMode::Naive);
+
+        inline bool WasLastCompileIncremental() const { return m_LastCompileIncremental; }
+
+    private:
+        struct CompileCache
+        {
+            bool valid { false };
+            ScheduleMode mode { ScheduleMode::Naive };
+            bool hasImportedUses { false };
+
+            std::vector<char> passAlive;
+            std::vector<PassHandle> execOrder;
+
+            std::vector<std::vector<std::pair<PassHandle, PassHandle>>> resourceEdges;
+            std::vector<std::vector<PassHandle>> resourceUsers;
+            std::vector<std::vector<Barrier>> resourceBarriers;
+        };
+
+    private:
+        ExecutionPlan Compile(ScheduleMode mode, bool incremental);
+
+        PassHandle InsertPass(Pass pass, const std::function<void(class RenderGraph::PassBuilder&)>& setup);
+
+        bool HasImportedUses() const;
+        bool CanCompileIncrementally(ScheduleMode mode) const;
+
+        void ComputeLiveness();
+        void PatchLiveness(std::vector<char>& touchedResources);
+
+        void BuildResourceEdges(ResourceHandle resource);
+        void BuildResourceBarriers(ResourceHandle resource, const std::vector<i32>& passPosition);
+
+        std::vector<i32> SchedulePasses(const std::vector<PassHandle>& alivePasses, const std::vector<std::vector<i32>>& adj, ScheduleMode mode) const;
 
     private:
         std::vector<Resource> m_Resources;
         std::vector<Pass> m_Passes;
+
+        std::vector<std::vector<std::pair<PassHandle, AccessInfo>>> m_ResourceUses;
+        std::vector<PassHandle> m_DirtyPasses;
+        usize m_LivePassCount { 0 };
+
+        CompileCache m_Cache;
+        bool m_LastCompileIncremental { false };
     };
 
 }
@@ -0,0 +1,217 @@
+#include "RenderGraphAllocator.hpp"
+
+#include <algorithm>
+
+namespace Renderer {
+
+    RenderGraphAllocator::RenderGraphAllocator(const Ref<VulkanContext>& context, const Ref<VulkanDeletionQueue>& deletionQueue)
+        : m_Context(context), m_DeletionQueue(deletionQueue)
+    {
+    }
+
+    RenderGraphAllocator::~RenderGraphAllocator()
+    {
+        Clear();
+    }
+
+    void RenderGraphAllocator::Allocate(
+        const ExecutionPlan& plan,
+        VkExtent2D minExtent,
+        std::unordered_map<ResourceHandle, VkImage>& images,
+        std::unordered_map<ResourceHandle, VkImageView>& imageViews
+    )
+    {
+        usize slotCount = 0;
+        for (i32 id : plan.allocationIdPerResource)
+            slotCount = std::max(slotCount, static_cast<usize>(id + 1));
+
+        // Resources aliased into one slot must share format and sample count;
+        // any that do not get a slot of their own.
+        std::vector<ImageDesc> required(slotCount);
+        std::vector<u32> slotPerResource(plan.resources.size(), std::numeric_limits<u32>::max());
+
+        for (ResourceHandle r = 0; r < plan.resources.size(); ++r) {
+            const Resource& resource = plan.resources[r];
+            if (resource.imported || resource.type != ResourceType::Image)
+                continue;
+
+            i32 id = r < plan.allocationIdPerResource.size() ? plan.allocationIdPerResource[r] : -1;
+            if (id == -1)
+                continue;
+
+            u32 slot = static_cast<u32>(id);
+            const ImageDesc& desc = resource.imageDesc;
+
+            if (required[slot].format != VK_FORMAT_UNDEFINED && (required[slot].format != desc.format || required[slot].samples != desc.samples)) {
+                slot = static_cast<u32>(required.size());
+                required.push_back({});
+            }
+
+            ImageDesc& slotDesc = required[slot];
+            slotDesc.format = desc.format;
+            slotDesc.samples = desc.samples;
+            slotDesc.usage |= desc.usage;
+            slotDesc.width = std::max(slotDesc.width, desc.width);
+            slotDesc.height = std::max(slotDesc.height, desc.height);
+
+            slotPerResource[r] = slot;
+        }
+
+        if (m_Allocations.size() < required.size())
+            m_Allocations.resize(required.size());
+
+        // Images are only replaced when they cannot hold the request, so a
+        // resource whose extent changes every frame renders into a sub-rect of
+        // an over-allocated image. Replaced images may still be in use by
+        // frames in flight and are handed to the deletion queue.
+        for (usize slot = 0; slot < required.size(); ++slot) {
+            const ImageDesc& desc = required[slot];
+            Allocation& allocation = m_Allocations[slot];
+
+            if (desc.format == VK_FORMAT_UNDEFINED || IsCompatible(allocation, desc))
+                continue;
+
+            ReleaseImage(allocation);
+
+            allocation.extent = {
+                .width = std::max({ desc.width, minExtent.width, allocation.extent.width }),
+                .height = std::max({ desc.height, minExtent.height, allocation.extent.height })
+            };
+            allocation.format = desc.format;
+            allocation.usage = desc.usage;
+            allocation.samples = desc.samples;
+
+            CreateImage(allocation);
+        }
+
+        for (ResourceHandle r = 0; r < plan.resources.size(); ++r) {
+            u32 slot = slotPerResource[r];
+            if (slot == std::numeric_limits<u32>::max())
+                continue;
+
+            images[r] = m_Allocations[slot].image;
+            imageViews[r] = m_Allocations[slot].view;
+        }
+    }
+
+    void RenderGraphAllocator::Clear()
+    {
+        for (auto& allocation : m_Allocations)
+            DestroyImage(allocation);
+
+        m_Allocations.clear();
+    }
+
+    bool RenderGraphAllocator::IsCompatible(const Allocation& allocation, const ImageDesc& desc)
+    {
+        return allocation.image != VK_NULL_HANDLE
+            && allocation.format == desc.format
+            && allocation.samples == desc.samples
+            && (allocation.usage & desc.usage) == desc.usage
+            && allocation.extent.width >= desc.width
+            && allocation.extent.height >= desc.height;
+    }
+
+    void RenderGraphAllocator::CreateImage(Allocation& allocation)
+    {
+        VkImageCreateInfo imageInfo {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = allocation.format,
+            .extent = {
+                .width = allocation.extent.width,
+                .height = allocation.extent.height,
+                .depth = 1
+            },
+            .mipLevels = 1,
+            .arrayLayers = 1,
+            .samples = allocation.samples,
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            .usage = allocation.usage,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .queueFamilyIndexCount = 0,
+            .pQueueFamilyIndices = nullptr,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+        };
+
+        VK_CHECK(vkCreateImage(m_Context->GetDevice(), &imageInfo, nullptr, &allocation.image));
+
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(m_Context->GetDevice(), allocation.image, &requirements);
+
+        auto memoryType = m_Context->FindMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (!memoryType.has_value())
+            memoryType = m_Context->FindMemoryType(requirements.memoryTypeBits, 0);
+
+        VkMemoryAllocateInfo allocInfo {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .pNext = nullptr,
+            .allocationSize = requirements.size,
+            .memoryTypeIndex = memoryType.value()
+        };
+
+        VK_CHECK(vkAllocateMemory(m_Context->GetDevice(), &allocInfo, nullptr, &allocation.memory));
+        VK_CHECK(vkBindImageMemory(m_Context->GetDevice(), allocation.image, allocation.memory, 0));
+
+        VkImageViewCreateInfo viewInfo {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .image = allocation.image,
+            .viewType = VK_IMAGE_VIEW_TYPE_2D,
+            .format = allocation.format,
+            .components = {
+                .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+                .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+                .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+                .a = VK_COMPONENT_SWIZZLE_IDENTITY
+            },
+            .subresourceRange = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1
+            }
+        };
+
+        VK_CHECK(vkCreateImageView(m_Context->GetDevice(), &viewInfo, nullptr, &allocation.view));
+
+        LOG_INFO("Allocated render graph image ({}, {})", allocation.extent.width, allocation.extent.height)
+    }
+
+    void RenderGraphAllocator::ReleaseImage(Allocation& allocation)
+    {
+        if (allocation.image == VK_NULL_HANDLE)
+            return;
+
+        m_DeletionQueue->Defer([context = m_Context, released = allocation]() {
+            vkDestroyImageView(context->GetDevice(), released.view, nullptr);
+            vkDestroyImage(context->GetDevice(), released.image, nullptr);
+            vkFreeMemory(context->GetDevice(), released.memory, nullptr);
+        });
+
+        allocation.view = VK_NULL_HANDLE;
+        allocation.image = VK_NULL_HANDLE;
+        allocation.memory = VK_NULL_HANDLE;
+    }
+
+    void RenderGraphAllocator::DestroyImage(Allocation& allocation)
+    {
+        if (allocation.view != VK_NULL_HANDLE)
+            vkDestroyImageView(m_Context->GetDevice(), allocation.view, nullptr);
+
+        if (allocation.image != VK_NULL_HANDLE)
+            vkDestroyImage(m_Context->GetDevice(), allocation.image, nullptr);
+
+        if (allocation.memory != VK_NULL_HANDLE)
+            vkFreeMemory(m_Context->GetDevice(), allocation.memory, nullptr);
+
+        allocation.view = VK_NULL_HANDLE;
+        allocation.image = VK_NULL_HANDLE;
+        allocation.memory = VK_NULL_HANDLE;
+    }
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "RenderGraph.hpp"
+#include "Vulkan/VulkanContext.hpp"
+#include "Vulkan/VulkanDeletionQueue.hpp"
+
+namespace Renderer {
+
+    class RenderGraphAllocator
+    {
+    public:
+        struct Allocation
+        {
+            VkImage image { VK_NULL_HANDLE };
+            VkDeviceMemory memory { VK_NULL_HANDLE };
+            VkImageView view { VK_NULL_HANDLE };
+            VkExtent2D extent { 0, 0 };
+            VkFormat format { VK_FORMAT_UNDEFINED };
+            VkImageUsageFlags usage { 0 };
+            VkSampleCountFlagBits samples { VK_SAMPLE_COUNT_1_BIT };
+        };
+
+    public:
+        RenderGraphAllocator(const Ref<VulkanContext>& context, const Ref<VulkanDeletionQueue>& deletionQueue);
+        ~RenderGraphAllocator();
+
+        void Allocate(
+            const ExecutionPlan& plan,
+            VkExtent2D minExtent,
+            std::unordered_map<ResourceHandle, VkImage>& images,
+            std::unordered_map<ResourceHandle, VkImageView>& imageViews
+        );
+
+        void Clear();
+
+    private:
+        static bool IsCompatible(const Allocation& allocation, const ImageDesc& desc);
+
+        void CreateImage(Allocation& allocation);
+        void DestroyImage(Allocation& allocation);
+        void ReleaseImage(Allocation& allocation);
+
+    private:
+        Ref<VulkanContext> m_Context;
+        Ref<VulkanDeletionQueue> m_DeletionQueue;
+
+        std::vector<Allocation> m_Allocations;
+    };
+
+}
@@ -0,0 +1,277 @@
+#include "RenderGraphExport.hpp"
+
+#include <fstream>
+#include <iomanip>
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include "Core/Json.hpp"
+
+namespace Renderer {
+
+    std::string RenderGraphExporter::ToDot(const RenderGraph& graph, const ExecutionPlan& plan, const PassTimings& timings)
+    {
+        std::vector<i32> passPosition(graph.GetPassCount(), -1);
+        for (i32 i = 0; i < static_cast<i32>(plan.orderedPasses.size()); ++i)
+            passPosition.at(plan.orderedPasses[i].pass) = i;
+
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+
+        out << "digraph RenderGraph {\n";
+        out << "    rankdir=LR;\n";
+        out << "    node [fontname=\"Helvetica\", fontsize=10];\n";
+        out << "    edge [fontname=\"Helvetica\", fontsize=9];\n\n";
+
+        for (const auto& execPass : plan.orderedPasses) {
+            out << "    p" << execPass.pass << " [shape=box, style=filled, fillcolor=\"#dbe8f7\", label=\"#"
+                << passPosition.at(execPass.pass) << " " << EscapeLabel(execPass.name);
+
+            if (auto it = timings.find(execPass.pass); it != timings.end()) {
+                if (it->second.cpuRecordMs.has_value())
+                    out << "\\ncpu " << *it->second.cpuRecordMs << " ms";
+
+                if (it->second.gpuMs.has_value())
+                    out << "\\ngpu " << *it->second.gpuMs << " ms";
+            }
+
+            out << "\"];\n";
+        }
+
+        for (const auto& culled : plan.culledPasses) {
+            out << "    p" << culled.pass << " [shape=box, style=dashed, color=gray50, fontcolor=gray50, label=\""
+                << EscapeLabel(culled.name) << "\\n(culled)\"];\n";
+        }
+
+        out << "\n";
+
+        for (ResourceHandle r = 0; r < plan.resources.size(); ++r) {
+            const auto& res = plan.resources[r];
+
+            out << "    r" << r << " [shape=ellipse, label=\"" << EscapeLabel(res.name);
+
+            if (res.firstUse != -1)
+                out << "\\n[" << res.firstUse << ", " << res.lastUse << "]";
+            else
+                out << "\\n(unused)";
+
+            if (r < plan.allocationIdPerResource.size() && plan.allocationIdPerResource[r] != -1)
+                out << " slot " << plan.allocationIdPerResource[r];
+
+            out << "\"";
+
+            if (res.imported)
+                out << ", peripheries=2";
+            else if (res.imageDesc.transient)
+                out << ", style=dashed";
+
+            out << "];\n";
+        }
+
+        out << "\n";
+
+        for (PassHandle p = 0; p < graph.GetPassCount(); ++p) {
+            const Pass& pass = graph.GetPass(p);
+            if (pass.removed)
+                continue;
+
+            for (const auto& ai : pass.accesses) {
+                if (ai.type != AccessType::Write)
+                    out << "    r" << ai.resource << " -> p" << p << " [color=gray40, label=\"" << LayoutName(ai.layout) << "\"];\n";
+
+                if (ai.type != AccessType::Read)
+                    out << "    p" << p << " -> r" << ai.resource << " [color=gray40, label=\"" << LayoutName(ai.layout) << "\"];\n";
+            }
+        }
+
+        out << "\n";
+
+        for (const auto& [src, dst] : plan.edges)
+            out << "    p" << src << " -> p" << dst << " [style=dotted, constraint=false];\n";
+
+        for (const auto& barrier : plan.barriers) {
+            if (barrier.srcPass == std::numeric_limits<u32>::max())
+                continue;
+
+            out << "    p" << barrier.srcPass << " -> p" << barrier.dstPass << " [color=red, fontcolor=red, constraint=false, label=\""
+                << EscapeLabel(plan.resources.at(barrier.resource).name) << "\\n"
+                << LayoutName(barrier.oldLayout) << " -> " << LayoutName(barrier.newLayout) << "\"];\n";
+        }
+
+        out << "}\n";
+
+        return out.str();
+    }
+
+    std::string RenderGraphExporter::ToJson(const RenderGraph& graph, const ExecutionPlan& plan, const PassTimings& timings)
+    {
+        std::vector<i32> passPosition(graph.GetPassCount(), -1);
+        for (i32 i = 0; i < static_cast<i32>(plan.orderedPasses.size()); ++i)
+            passPosition.at(plan.orderedPasses[i].pass) = i;
+
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(6);
+
+        out << "{\n  \"passes\": [";
+
+        bool first = true;
+        for (PassHandle p = 0; p < graph.GetPassCount(); ++p) {
+            const Pass& pass = graph.GetPass(p);
+            if (pass.removed)
+                continue;
+
+            PassTiming timing {};
+            if (auto it = timings.find(p); it != timings.end())
+                timing = it->second;
+
+            out << (first ? "\n" : ",\n");
+            first = false;
+
+            out << "    { \"handle\": " << p
+                << ", \"name\": " << JsonString { pass.name }
+                << ", \"order\": " << passPosition.at(p)
+                << ", \"culled\": " << (passPosition.at(p) == -1 ? "true" : "false")
+                << ", \"asyncCompute\": " << (pass.asyncCompute ? "true" : "false")
+                << ", \"cpuRecordMs\": ";
+            WriteOptional(out, timing.cpuRecordMs);
+            out << ", \"gpuMs\": ";
+            WriteOptional(out, timing.gpuMs);
+            out << ", \"accesses\": [";
+
+            for (usize i = 0; i < pass.accesses.size(); ++i) {
+                const auto& ai = pass.accesses[i];
+                out << (i == 0 ? "" : ", ")
+                    << "{ \"resource\": " << ai.resource
+                    << ", \"type\": \"" << AccessTypeName(ai.type) << "\""
+                    << ", \"layout\": \"" << string_VkImageLayout(ai.layout) << "\""
+                    << ", \"stage\": \"" << string_VkPipelineStageFlags(ai.stage) << "\""
+                    << ", \"access\": \"" << string_VkAccessFlags(ai.accessMask) << "\" }";
+            }
+
+            out << "] }";
+        }
+
+        out << "\n  ],\n  \"edges\": [";
+
+        for (usize i = 0; i < plan.edges.size(); ++i) {
+            out << (i == 0 ? "\n" : ",\n")
+                << "    { \"src\": " << plan.edges[i].first << ", \"dst\": " << plan.edges[i].second << " }";
+        }
+
+        out << "\n  ],\n  \"resources\": [";
+
+        for (ResourceHandle r = 0; r < plan.resources.size(); ++r) {
+            const auto& res = plan.resources[r];
+            i32 slot = r < plan.allocationIdPerResource.size() ? plan.allocationIdPerResource[r] : -1;
+
+            out << (r == 0 ? "\n" : ",\n")
+                << "    { \"handle\": " << r
+                << ", \"name\": " << JsonString { res.name }
+                << ", \"imported\": " << (res.imported ? "true" : "false")
+                << ", \"transient\": " << (res.imageDesc.transient ? "true" : "false")
+                << ", \"width\": " << res.imageDesc.width
+                << ", \"height\": " << res.imageDesc.height
+                << ", \"format\": \"" << string_VkFormat(res.imageDesc.format) << "\""
+                << ", \"firstUse\": " << res.firstUse
+                << ", \"lastUse\": " << res.lastUse
+                << ", \"aliasSlot\": " << slot << " }";
+        }
+
+        out << "\n  ],\n  \"barriers\": [";
+
+        for (usize i = 0; i < plan.barriers.size(); ++i) {
+            const auto& b = plan.barriers[i];
+
+            out << (i == 0 ? "\n" : ",\n") << "    { \"resource\": " << b.resource << ", \"srcPass\": ";
+            if (b.srcPass == std::numeric_limits<u32>::max())
+                out << "null";
+            else
+                out << b.srcPass;
+
+            out << ", \"dstPass\": " << b.dstPass
+                << ", \"oldLayout\": \"" << string_VkImageLayout(b.oldLayout) << "\""
+                << ", \"newLayout\": \"" << string_VkImageLayout(b.newLayout) << "\""
+                << ", \"srcStage\": \"" << string_VkPipelineStageFlags(b.srcStageMask) << "\""
+                << ", \"dstStage\": \"" << string_VkPipelineStageFlags(b.dstStageMask) << "\""
+                << ", \"srcAccess\": \"" << string_VkAccessFlags(b.srcAccessMask) << "\""
+                << ", \"dstAccess\": \"" << string_VkAccessFlags(b.dstAccessMask) << "\" }";
+        }
+
+        out << "\n  ],\n  \"stats\": { \"barrierCount\": " << plan.stats.barrierCount
+            << ", \"barrierBatchCount\": " << plan.stats.barrierBatchCount
+            << ", \"criticalPathLength\": " << plan.stats.criticalPathLength
+            << ", \"criticalPath\": [";
+
+        for (usize i = 0; i < plan.stats.criticalPath.size(); ++i)
+            out << (i == 0 ? "" : ", ") << plan.stats.criticalPath[i];
+
+        out << "] }\n}\n";
+
+        return out.str();
+    }
+
+    bool RenderGraphExporter::WriteFile(const std::string& filepath, const std::string& contents)
+    {
+        std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+
+        if (!file.is_open()) {
+            LOG_ERROR("Failed to open file {}", filepath)
+            return false;
+        }
+
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        LOG_INFO("Wrote render graph export {}", filepath)
+
+        return true;
+    }
+
+    std::string_view RenderGraphExporter::LayoutName(VkImageLayout layout)
+    {
+        static constexpr std::string_view prefix = "VK_IMAGE_LAYOUT_";
+
+        std::string_view name = string_VkImageLayout(layout);
+        if (name.starts_with(prefix))
+            name.remove_prefix(prefix.size());
+
+        return name;
+    }
+
+    const char* RenderGraphExporter::AccessTypeName(AccessType type)
+    {
+        switch (type) {
+            case AccessType::Read: return "read";
+            case AccessType::Write: return "write";
+            case AccessType::ReadWrite: return "readwrite";
+        }
+
+        return "unknown";
+    }
+
+    void RenderGraphExporter::WriteOptional(std::ostringstream& out, const std::optional<f64>& value)
+    {
+        if (value.has_value())
+            out << *value;
+        else
+            out << "null";
+    }
+
+    std::string RenderGraphExporter::EscapeLabel(const std::string& text)
+    {
+        std::string escaped;
+        escaped.reserve(text.size());
+
+        // DOT labels have no escapes for control characters, so other than
+        // line breaks they are replaced with spaces.
+        for (char c : text) {
+            switch (c) {
+                case '"': escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n"; break;
+                default: escaped += static_cast<unsigned char>(c) < 0x20 ? ' ' : c;
+            }
+        }
+
+        return escaped;
+    }
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <unordered_map>
+
+#include "RenderGraph.hpp"
+
+namespace Renderer {
+
+    struct PassTiming
+    {
+        std::optional<f64> cpuRecordMs;
+        std::optional<f64> gpuMs;
+    };
+
+    using PassTimings = std::unordered_map<PassHandle, PassTiming>;
+
+    class RenderGraphExporter
+    {
+    public:
+        static std::string ToDot(const RenderGraph& graph, const ExecutionPlan& plan, const PassTimings& timings = {});
+        static std::string ToJson(const RenderGraph& graph, const ExecutionPlan& plan, const PassTimings& timings = {});
+
+        static bool WriteFile(const std::string& filepath, const std::string& contents);
+
+    private:
+        static std::string_view LayoutName(VkImageLayout layout);
+        static const char* AccessTypeName(AccessType type);
+        static void WriteOptional(std::ostringstream& out, const std::optional<f64>& value);
+        static std::string EscapeLabel(const std::string& text);
+    };
+
+}
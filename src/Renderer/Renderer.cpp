@@ -1,13 +1,29 @@
 #include "Renderer.hpp"
 
+#include <filesystem>
+
 // TEMPORARY
 #include "Vulkan/VulkanShader.hpp"
 #include "RenderGraph.hpp"
+#include "RenderGraphExport.hpp"
+
+#include "Core/Profiler.hpp"
 
 namespace Renderer {
 
     Renderer::Renderer(const Ref<Window>& window)
-        : m_Window(window)
+        : Renderer(window, Config {})
+    {
+    }
+
+    Renderer::Renderer(const Ref<Window>& window, const Config& config)
+        : m_Window(window), m_WindowExtent { window->Width(), window->Height() }, m_ContextConfig(config.context), m_ShaderObjects(config.shaderObjects), m_ScheduleMode(config.schedule), m_GraphDumpPath(config.graphDumpPath), m_FramePacer(CreateScope<FramePacer>(config.pacing))
+    {
+        m_RenderThread = std::thread(&Renderer::RenderThreadLoop, this);
+    }
+
+    Renderer::Renderer(const HeadlessConfig& config)
+        : m_HeadlessConfig(config), m_ContextConfig(config.context), m_ShaderObjects(config.shaderObjects), m_ScheduleMode(config.schedule), m_GraphDumpPath(config.graphDumpPath), m_FramePacer(CreateScope<FramePacer>(FramePacer::Config {}))
     {
         m_RenderThread = std::thread(&Renderer::RenderThreadLoop, this);
     }
@@ -33,6 +49,8 @@ namespace Renderer {
 
     void Renderer::Submit(std::vector<RenderPacket>& packets)
     {
+        PROFILE_SCOPE("Renderer::Submit")
+
         {
             std::lock_guard<std::mutex> lock(m_RenderMutex);
             m_StagingQueue.swap(packets);
@@ -41,8 +59,57 @@ namespace Renderer {
         m_QueueCondition.notify_one();
     }
 
+    u64 Renderer::GetProcessedFrameCount()
+    {
+        std::lock_guard<std::mutex> lock(m_RenderMutex);
+        return m_ProcessedFrames;
+    }
+
+    void Renderer::WaitForFrame(u64 frame)
+    {
+        std::unique_lock<std::mutex> lock(m_RenderMutex);
+        m_FrameCondition.wait(lock, [&]{
+            return m_ProcessedFrames >= frame || !m_Running;
+        });
+    }
+
+    void Renderer::RequestCapture(const VulkanFrameCapture::Request& request)
+    {
+        std::lock_guard<std::mutex> lock(m_RenderMutex);
+        m_CaptureRequest = request;
+    }
+
+    void Renderer::SetDynamicResolution(const DynamicResolution::Config& config)
+    {
+        std::lock_guard<std::mutex> lock(m_RenderMutex);
+        m_ResolutionRequest = config;
+    }
+
+    std::vector<Renderer::FrameStats> Renderer::ConsumeFrameStats()
+    {
+        std::lock_guard<std::mutex> lock(m_RenderMutex);
+        return std::exchange(m_FrameStats, {});
+    }
+
+    std::unordered_map<std::string, VulkanGpuProfiler::ScopeStats> Renderer::GetGpuStats()
+    {
+        std::lock_guard<std::mutex> lock(m_RenderMutex);
+
+        if (!m_GpuProfiler)
+            return {};
+
+        return m_GpuProfiler->GetStats();
+    }
+
+    Renderer::ScheduleSummary Renderer::GetScheduleSummary()
+    {
+        std::lock_guard<std::mutex> lock(m_RenderMutex);
+        return m_ScheduleSummary;
+    }
+
     void Renderer::RenderThreadLoop()
     {
+        PROFILE_THREAD("Render")
         LOG_INFO("Render thread running")
 
         CreateResources();
@@ -50,9 +117,12 @@ namespace Renderer {
         while (m_Running) {
             std::unique_lock<std::mutex> lock(m_RenderMutex);
 
-            m_QueueCondition.wait(lock, [this]{
-                return !m_StagingQueue.empty() || !m_Running || m_ResizeRequest.pending;
-            });
+            {
+                PROFILE_SCOPE("Renderer::WaitForWork")
+                m_QueueCondition.wait(lock, [this]{
+                    return !m_StagingQueue.empty() || !m_Running || m_ResizeRequest.pending;
+                });
+            }
 
             if (m_ResizeRequest.pending) {
                 lock.unlock();
@@ -64,49 +134,341 @@ namespace Renderer {
                 break;
 
             m_RenderQueue.swap(m_StagingQueue);
+            m_CurrentFrameStats = { .frame = m_ProcessedFrames + 1 };
+            m_FrameInputNs = m_RenderQueue.empty() ? 0 : m_RenderQueue.back().inputTimestampNs;
             lock.unlock();
 
+            i64 frameStartNs = Profiler::Now();
             ProcessFrame();
+            m_CurrentFrameStats.renderMs = static_cast<f64>(Profiler::Now() - frameStartNs) / 1'000'000.0;
             m_RenderQueue.clear();
+
+            {
+                std::lock_guard<std::mutex> frameLock(m_RenderMutex);
+                m_ProcessedFrames++;
+
+                if (m_FrameStatsEnabled)
+                    m_FrameStats.push_back(m_CurrentFrameStats);
+            }
+            m_FrameCondition.notify_all();
         }
 
         vkDeviceWaitIdle(m_Context->GetDevice());
+
+        if (!m_GraphDumpPath.empty())
+            WriteGraphDump();
+
         DestroyResources();
     }
 
     void Renderer::ProcessFrame()
     {
-        VK_CHECK(vkWaitForFences(m_Context->GetDevice(), 1, &m_Sync.at(m_FrameIndex).inFlight, VK_TRUE, std::numeric_limits<u64>::max()));
+        PROFILE_SCOPE("Renderer::ProcessFrame")
 
-        if (!m_Swapchain->AcquireNextImage(m_Sync.at(m_FrameIndex).imageAvailable)) {
-            return;
+        m_FramePacer->RecordFrameStart(Profiler::Now());
+
+        {
+            PROFILE_SCOPE("Renderer::WaitForFrameFence")
+            VK_CHECK(vkWaitForFences(m_Context->GetDevice(), 1, &m_Sync.at(m_FrameIndex).inFlight, VK_TRUE, std::numeric_limits<u64>::max()));
+        }
+
+        // The slot's previous frame, s_FrameInFlight frames back, has now
+        // completed, so its GPU time is read back without stalling.
+        if (auto gpuMs = m_GpuProfiler->ResolveFrame(m_FrameIndex)) {
+            m_CurrentFrameStats.gpuMs = gpuMs.value();
+            m_DynamicResolution->Update(gpuMs.value());
+        }
+
+        m_CommandAllocator->BeginFrame(m_FrameIndex);
+        m_DeletionQueue->Collect(m_GraphicsSubmitter->GetCompletedValue());
+
+        {
+            std::lock_guard<std::mutex> lock(m_RenderMutex);
+            if (m_CaptureRequest.has_value()) {
+                m_FrameCapture->Start(m_CaptureRequest.value());
+                m_CaptureRequest.reset();
+            }
+
+            if (m_ResolutionRequest.has_value()) {
+                m_DynamicResolution = CreateScope<DynamicResolution>(m_ResolutionRequest.value());
+                m_ResolutionRequest.reset();
+            }
+        }
+
+        m_FrameCapture->Collect();
+
+        std::optional<Backbuffer> backbuffer;
+        {
+            PROFILE_SCOPE("Renderer::AcquireImage")
+            backbuffer = AcquireBackbuffer();
+            if (!backbuffer.has_value()) {
+                return;
+            }
         }
 
         vkResetFences(m_Context->GetDevice(), 1, &m_Sync.at(m_FrameIndex).inFlight);
 
-        RenderGraph rg;
+        m_Frame.backbuffer = backbuffer.value();
+        m_Frame.renderExtent = m_DynamicResolution->GetRenderExtent(backbuffer->extent);
+        m_Frame.images.clear();
+
+        m_CurrentFrameStats.renderScale = m_DynamicResolution->IsEnabled() ? m_DynamicResolution->GetScale() : 1.0f;
+
+        // Until the background compile finishes the pass only clears. Runs
+        // that measure or capture frames wait instead, so that none of their
+        // frames are empty.
+        if (m_TrianglePipeline && !m_TrianglePipeline->IsReady() && (IsHeadless() || m_FrameStatsEnabled || m_FrameCapture->IsCapturing())) {
+            PROFILE_SCOPE("Renderer::WaitForPipelines")
+            m_PipelineCompiler->WaitIdle();
+        }
+
+        m_Frame.pipeline = m_TrianglePipeline ? m_TrianglePipeline->Get() : nullptr;
+
+        // The graph outlives the frame and is only rebuilt when the targets
+        // change shape; toggling capture edits it in place, so most frames
+        // take the incremental compile path.
+        VkExtent2D sceneExtent = m_DynamicResolution->GetMaxExtent(backbuffer->extent);
+        if (!m_FrameGraph
+            || m_FrameGraph->extent.width != backbuffer->extent.width || m_FrameGraph->extent.height != backbuffer->extent.height
+            || m_FrameGraph->format != backbuffer->format
+            || m_FrameGraph->dynamicResolution != m_DynamicResolution->IsEnabled()
+            || m_FrameGraph->sceneExtent.width != sceneExtent.width || m_FrameGraph->sceneExtent.height != sceneExtent.height) {
+            BuildFrameGraph(backbuffer.value());
+        }
+
+        UpdateCapturePass();
+
+        const RenderGraph& rg = m_FrameGraph->graph;
+        ExecutionPlan plan = m_FrameGraph->graph.Compile(m_ScheduleMode);
+
+        {
+            std::lock_guard<std::mutex> lock(m_RenderMutex);
+            m_ScheduleSummary.mode = m_ScheduleMode;
+            m_ScheduleSummary.stats = plan.stats;
+            m_ScheduleSummary.criticalPath.clear();
+            for (PassHandle pass : plan.stats.criticalPath)
+                m_ScheduleSummary.criticalPath.push_back(rg.GetPass(pass).name);
+        }
+
+        std::unordered_map<ResourceHandle, VkImageView> imageViews;
+        m_Frame.images[m_FrameGraph->backbuffer] = backbuffer->image;
+        imageViews[m_FrameGraph->backbuffer] = backbuffer->view;
+
+        m_GraphAllocator->Allocate(plan, sceneExtent, m_Frame.images, imageViews);
+
+        std::unordered_map<ResourceHandle, VkImageLayout> currentLayouts;
+        for (const auto& [handle, _] : m_Frame.images)
+            currentLayouts[handle] = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        auto recordPass = [&](VkCommandBuffer cmd, const ExecutionPass& execPass) {
+            u32 gpuScope = m_GpuProfiler->BeginScope(cmd, execPass.name);
+
+            std::vector<VkImageMemoryBarrier> imageBarriers;
+            VkPipelineStageFlags srcStageMask = 0;
+            VkPipelineStageFlags dstStageMask = 0;
+
+            for (const auto& barrier : plan.barriers) {
+                if (barrier.dstPass == execPass.pass) {
+                    VkImageLayout oldLayout = currentLayouts.at(barrier.resource);
+
+                    imageBarriers.push_back(VkImageMemoryBarrier {
+                        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                        .pNext = nullptr,
+                        .srcAccessMask = barrier.srcAccessMask,
+                        .dstAccessMask = barrier.dstAccessMask,
+                        .oldLayout = oldLayout,
+                        .newLayout = barrier.newLayout,
+                        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                        .image = m_Frame.images.at(barrier.resource),
+                        .subresourceRange = {
+                            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                            .baseMipLevel = 0,
+                            .levelCount = 1,
+                            .baseArrayLayer = 0,
+                            .layerCount = 1
+                        }
+                    });
+                    srcStageMask |= barrier.srcStageMask;
+                    dstStageMask |= barrier.dstStageMask;
+                }
+            }
+
+            if (!imageBarriers.empty()) {
+                if (srcStageMask == 0)
+                    srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+
+                if (dstStageMask == 0)
+                    dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+                vkCmdPipelineBarrier(cmd,
+                    srcStageMask,
+                    dstStageMask,
+                    0,
+                    0, nullptr,
+                    0, nullptr,
+                    static_cast<u32>(imageBarriers.size()),
+                    imageBarriers.data()
+                );
+
+                for (const auto& b : plan.barriers) {
+                    if (b.dstPass == execPass.pass)
+                        currentLayouts[b.resource] = b.newLayout;
+                }
+            }
+
+            const auto& passInfo = rg.GetPass(execPass.pass);
+            if (passInfo.record) {
+                i64 recordStartNs = Profiler::Now();
+                passInfo.record(cmd, imageViews);
+                m_PassRecordMs[execPass.pass] = static_cast<f64>(Profiler::Now() - recordStartNs) / 1'000'000.0;
+            }
+
+            m_GpuProfiler->EndScope(cmd, gpuScope);
+        };
+
+        // Every pass records into a command buffer of its own, which the
+        // submitter coalesces into a single vkQueueSubmit2 on the flush.
+        std::vector<VkCommandBuffer> commandBuffers;
+        {
+            PROFILE_SCOPE("Renderer::RecordCommands")
+
+            m_PassRecordMs.clear();
+
+            usize passCount = plan.orderedPasses.size();
+            for (usize i = 0; i < std::max<usize>(passCount, 1); ++i) {
+                m_Commands->Record([&](const VkCommandBuffer& cmd) {
+                    // Bound state does not carry over between command buffers.
+                    m_DynamicState->Reset();
+
+                    if (i == 0)
+                        m_GpuProfiler->BeginFrame(cmd, m_FrameIndex);
+
+                    if (i < passCount)
+                        recordPass(cmd, plan.orderedPasses[i]);
+
+                    if (i + 1 >= passCount)
+                        m_GpuProfiler->EndFrame(cmd);
+                });
+
+                commandBuffers.push_back(m_Commands->GetCommandBuffer());
+            }
+        }
+
+        if (!m_GraphDumpPath.empty())
+            m_LastPlan = std::move(plan);
+
+        std::vector<VkSemaphoreSubmitInfo> waitSemaphores;
+        std::vector<VkSemaphoreSubmitInfo> signalSemaphores;
+
+        if (!IsHeadless()) {
+            waitSemaphores.push_back(VulkanQueueSubmitter::SemaphoreInfo(m_Sync.at(m_FrameIndex).imageAvailable, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT));
+            signalSemaphores.push_back(VulkanQueueSubmitter::SemaphoreInfo(m_Sync.at(m_FrameIndex).renderFinished, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT));
+        }
+
+        {
+            PROFILE_SCOPE("Renderer::SubmitCommands")
+
+            if (!IsHeadless()) {
+                i64 waitStartNs = Profiler::Now();
+                vkWaitForFences(m_Context->GetDevice(), 1, &m_Sync.at(m_FrameIndex).inPresent, VK_TRUE, std::numeric_limits<u64>::max());
+                m_CurrentFrameStats.presentMs += static_cast<f64>(Profiler::Now() - waitStartNs) / 1'000'000.0;
+            }
+
+            // Only the first pass waits for the backbuffer and only the last
+            // signals that the frame is ready to present.
+            for (usize i = 0; i < commandBuffers.size(); ++i) {
+                m_GraphicsSubmitter->Enqueue({
+                    .commandBuffers = { commandBuffers[i] },
+                    .waitSemaphores = i == 0 ? std::move(waitSemaphores) : std::vector<VkSemaphoreSubmitInfo> {},
+                    .signalSemaphores = i + 1 == commandBuffers.size() ? std::move(signalSemaphores) : std::vector<VkSemaphoreSubmitInfo> {}
+                });
+            }
+
+            u64 value = m_GraphicsSubmitter->Flush(m_Sync.at(m_FrameIndex).inFlight);
+            m_DeletionQueue->Retire(value);
+        }
+
+        if (!IsHeadless()) {
+            {
+                PROFILE_SCOPE("Renderer::Present")
+                i64 presentStartNs = Profiler::Now();
+                // Only swapchain_maintenance1 signals the present fence, so
+                // without it the fence stays signaled and never blocks.
+                if (m_Context->SupportsSwapchainMaintenance1())
+                    vkResetFences(m_Context->GetDevice(), 1, &m_Sync.at(m_FrameIndex).inPresent);
+
+                // The present queue is the graphics queue whenever the family
+                // allows it, so present under the submitter's queue lock.
+                VulkanSwapchain::Status status = VulkanSwapchain::Status::Error;
+                m_GraphicsSubmitter->Execute([&](VkQueue) {
+                    status = m_Swapchain->Present(m_Context->GetPresentQueue(), m_Sync.at(m_FrameIndex).renderFinished, m_Sync.at(m_FrameIndex).inPresent);
+                });
+                if (status == VulkanSwapchain::Status::Suboptimal || status == VulkanSwapchain::Status::OutOfDate)
+                    m_SwapchainDirty = true;
+
+                if (m_FramePacer->IsEnabled() && m_Context->SupportsPresentWait())
+                    m_FramePacer->QueuePresent(m_Swapchain->GetLastPresentId(), m_FrameInputNs);
+                m_CurrentFrameStats.presentMs += static_cast<f64>(Profiler::Now() - presentStartNs) / 1'000'000.0;
+            }
+
+            PaceFrame();
+        }
+
+        m_FrameIndex = (m_FrameIndex + 1) % s_FrameInFlight;
+    }
+
+    void Renderer::BuildFrameGraph(const Backbuffer& backbuffer)
+    {
+        PROFILE_SCOPE("Renderer::BuildFrameGraph")
+
+        m_FrameGraph = CreateScope<FrameGraph>();
+        m_FrameGraph->extent = backbuffer.extent;
+        m_FrameGraph->format = backbuffer.format;
+        m_FrameGraph->dynamicResolution = m_DynamicResolution->IsEnabled();
+        m_FrameGraph->sceneExtent = m_DynamicResolution->GetMaxExtent(backbuffer.extent);
+
+        RenderGraph& rg = m_FrameGraph->graph;
 
-        ImageDesc swapchainDesc {
-            .width = m_Swapchain->GetWidth(),
-            .height = m_Swapchain->GetHeight(),
-            .format = m_Swapchain->GetFormat(),
+        ImageDesc backbufferDesc {
+            .width = backbuffer.extent.width,
+            .height = backbuffer.extent.height,
+            .format = backbuffer.format,
         };
 
-        ResourceHandle swapchainHandle = rg.CreateImage("Swapchain", swapchainDesc);
+        ResourceHandle backbufferHandle = rg.CreateImage("Backbuffer", backbufferDesc, true);
 
-        Scope<VulkanGraphicsPipeline> pipeline = CreateScope<VulkanGraphicsPipeline>(m_Context, m_PipelineConfig);
+        // With dynamic resolution the scene renders into a pooled target,
+        // sized for the largest render extent, and is upscaled into the
+        // backbuffer. Each frame renders into a sub-rect of it.
+        ResourceHandle sceneHandle = backbufferHandle;
+
+        if (m_FrameGraph->dynamicResolution) {
+            sceneHandle = rg.CreateImage("SceneColor", ImageDesc {
+                .width = m_FrameGraph->sceneExtent.width,
+                .height = m_FrameGraph->sceneExtent.height,
+                .format = backbuffer.format,
+                .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                .transient = true
+            });
+        }
+
+        m_FrameGraph->backbuffer = backbufferHandle;
+        m_FrameGraph->scene = sceneHandle;
 
         rg.AddPass("DrawTriangle",
-            [&](RenderGraph::PassBuilder& builder) {
-                builder.Writes(swapchainHandle, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            [sceneHandle](RenderGraph::PassBuilder& builder) {
+                builder.Writes(sceneHandle, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
             },
-            [&](VkCommandBuffer cmd, const std::unordered_map<ResourceHandle, VkImageView>& imageViews) {
+            [this, sceneHandle](VkCommandBuffer cmd, const std::unordered_map<ResourceHandle, VkImageView>& imageViews) {
                 static constexpr VkClearValue clearColor = {{{ 0.0f, 0.0f, 0.0f, 1.0f }}};
 
+                VkExtent2D renderExtent = m_Frame.renderExtent;
+
                 VkRenderingAttachmentInfo colorAttachmentInfo {
                     .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR,
                     .pNext = nullptr,
-                    .imageView = imageViews.at(swapchainHandle),
+                    .imageView = imageViews.at(sceneHandle),
                     .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
                     .resolveMode = VK_RESOLVE_MODE_NONE,
                     .resolveImageView = VK_NULL_HANDLE,
@@ -122,7 +484,7 @@ namespace Renderer {
                     .flags = 0,
                     .renderArea = {
                         .offset = { 0, 0 },
-                        .extent = m_Swapchain->GetExtent()
+                        .extent = renderExtent
                     },
                     .layerCount = 1,
                     .viewMask = 0,
@@ -133,21 +495,28 @@ namespace Renderer {
                 };
 
                 vkCmdBeginRendering(cmd, &renderingInfo);
-                pipeline->Bind(cmd);
+
+                if (!m_Frame.pipeline) {
+                    vkCmdEndRendering(cmd);
+                    return;
+                }
+
+                m_DynamicState->BindPipeline(cmd, *m_Frame.pipeline);
+                m_DynamicState->Apply(cmd, m_PipelineConfig);
 
                 VkViewport viewport {
                     0.0f, 0.0f,
-                    static_cast<f32>(m_Swapchain->GetWidth()), static_cast<f32>(m_Swapchain->GetHeight()),
+                    static_cast<f32>(renderExtent.width), static_cast<f32>(renderExtent.height),
                     0.0f, 1.0f,
                 };
 
                 VkRect2D scissor {
                     { 0, 0 },
-                    m_Swapchain->GetExtent()
+                    renderExtent
                 };
 
-                vkCmdSetViewport(cmd, 0, 1, &viewport);
-                vkCmdSetScissor(cmd, 0, 1, &scissor);
+                m_DynamicState->SetViewport(cmd, viewport);
+                m_DynamicState->SetScissor(cmd, scissor);
 
                 vkCmdDraw(cmd, 3, 1, 0, 0);
 
@@ -155,123 +524,275 @@ namespace Renderer {
             }
         );
 
-        rg.AddPass("Present",
-            [&](RenderGraph::PassBuilder& builder) {
-                builder.Reads(swapchainHandle, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+        if (sceneHandle != backbufferHandle) {
+            rg.AddPass("Upscale",
+                [sceneHandle, backbufferHandle](RenderGraph::PassBuilder& builder) {
+                    builder.Reads(sceneHandle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+                    builder.Writes(backbufferHandle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+                },
+                [this, sceneHandle, backbufferHandle](VkCommandBuffer cmd, const std::unordered_map<ResourceHandle, VkImageView>&) {
+                    static constexpr VkImageSubresourceLayers subresource {
+                        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                        .mipLevel = 0,
+                        .baseArrayLayer = 0,
+                        .layerCount = 1
+                    };
+
+                    VkImageBlit region {
+                        .srcSubresource = subresource,
+                        .srcOffsets = {
+                            { 0, 0, 0 },
+                            { static_cast<i32>(m_Frame.renderExtent.width), static_cast<i32>(m_Frame.renderExtent.height), 1 }
+                        },
+                        .dstSubresource = subresource,
+                        .dstOffsets = {
+                            { 0, 0, 0 },
+                            { static_cast<i32>(m_Frame.backbuffer.extent.width), static_cast<i32>(m_Frame.backbuffer.extent.height), 1 }
+                        }
+                    };
+
+                    vkCmdBlitImage(cmd,
+                        m_Frame.images.at(sceneHandle), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                        m_Frame.images.at(backbufferHandle), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        1, &region,
+                        m_UpscaleFilter
+                    );
+                }
+            );
+        }
+
+        m_FrameGraph->output = AddOutputPass();
+    }
+
+    void Renderer::UpdateCapturePass()
+    {
+        RenderGraph& rg = m_FrameGraph->graph;
+        ResourceHandle backbufferHandle = m_FrameGraph->backbuffer;
+
+        bool capturing = m_FrameCapture->IsCapturing();
+        if (capturing == m_FrameGraph->capture.has_value())
+            return;
+
+        if (!capturing) {
+            rg.RemovePass(m_FrameGraph->capture.value());
+            m_FrameGraph->capture.reset();
+            return;
+        }
+
+        // Readers of one image are not ordered against each other, so the
+        // output pass is re-added after the copy to keep its layout last.
+        rg.RemovePass(m_FrameGraph->output);
+
+        m_FrameGraph->capture = rg.AddPass("Capture",
+            [backbufferHandle](RenderGraph::PassBuilder& builder) {
+                builder.Reads(backbufferHandle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+            },
+            [this](VkCommandBuffer cmd, const std::unordered_map<ResourceHandle, VkImageView>&) {
+                m_FrameCapture->RecordCopy(cmd, m_Frame.backbuffer.image, m_Frame.backbuffer.extent, m_Frame.backbuffer.format, m_Sync.at(m_FrameIndex).inFlight);
+            }
+        );
+
+        m_FrameGraph->output = AddOutputPass();
+    }
+
+    PassHandle Renderer::AddOutputPass()
+    {
+        RenderGraph& rg = m_FrameGraph->graph;
+        ResourceHandle backbufferHandle = m_FrameGraph->backbuffer;
+
+        if (IsHeadless()) {
+            return rg.AddPass("Output",
+                [backbufferHandle](RenderGraph::PassBuilder& builder) {
+                    builder.Reads(backbufferHandle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+                },
+                nullptr
+            );
+        }
+
+        return rg.AddPass("Present",
+            [backbufferHandle](RenderGraph::PassBuilder& builder) {
+                builder.Reads(backbufferHandle, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
             },
             nullptr
         );
+    }
 
-        ExecutionPlan plan = rg.Compile();
+    void Renderer::WriteGraphDump()
+    {
+        if (!m_FrameGraph)
+            return;
 
-        std::unordered_map<ResourceHandle, VkImage> images;
-        std::unordered_map<ResourceHandle, VkImageView> imageViews;
+        // After the idle wait the last submitted frame is complete, so its
+        // GPU timings can be read back to annotate the plan it ran.
+        m_GpuProfiler->ResolveFrame((m_FrameIndex + s_FrameInFlight - 1) % s_FrameInFlight);
+        auto gpuTimings = m_GpuProfiler->GetLastFrameTimings();
 
-        images[swapchainHandle] = m_Swapchain->GetCurrentImage();
-        imageViews[swapchainHandle] = m_Swapchain->GetCurrentImageView();
-
-        m_Commands.at(m_FrameIndex)->Record([&](const VkCommandBuffer& cmd) {
-            std::unordered_map<ResourceHandle, VkImageLayout> currentLayouts;
-            currentLayouts[swapchainHandle] = VK_IMAGE_LAYOUT_UNDEFINED;
-
-            for (const auto& execPass : plan.orderedPasses) {
-                std::vector<VkImageMemoryBarrier> imageBarriers;
-                VkPipelineStageFlags srcStageMask = 0;
-                VkPipelineStageFlags dstStageMask = 0;
-
-                for (const auto& barrier : plan.barriers) {
-                    if (barrier.dstPass == execPass.pass) {
-                        VkImageLayout oldLayout = currentLayouts.at(barrier.resource);
-
-                        imageBarriers.push_back(VkImageMemoryBarrier {
-                            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-                            .pNext = nullptr,
-                            .srcAccessMask = barrier.srcAccessMask,
-                            .dstAccessMask = barrier.dstAccessMask,
-                            .oldLayout = oldLayout,
-                            .newLayout = barrier.newLayout,
-                            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                            .image = images.at(barrier.resource),
-                            .subresourceRange = {
-                                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-                                .baseMipLevel = 0,
-                                .levelCount = 1,
-                                .baseArrayLayer = 0,
-                                .layerCount = 1
-                            }
-                        });
-                        srcStageMask |= barrier.srcStageMask;
-                        dstStageMask |= barrier.dstStageMask;
-                    }
-                }
+        PassTimings timings;
+        for (const auto& execPass : m_LastPlan.orderedPasses) {
+            PassTiming& timing = timings[execPass.pass];
 
-                if (!imageBarriers.empty()) {
-                    if (srcStageMask == 0)
-                        srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-
-                    if (dstStageMask == 0)
-                        dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-
-                    vkCmdPipelineBarrier(cmd,
-                        srcStageMask,
-                        dstStageMask,
-                        0,
-                        0, nullptr,
-                        0, nullptr,
-                        static_cast<u32>(imageBarriers.size()),
-                        imageBarriers.data()
-                    );
+            if (auto it = m_PassRecordMs.find(execPass.pass); it != m_PassRecordMs.end())
+                timing.cpuRecordMs = it->second;
 
-                    for (const auto& b : plan.barriers) {
-                        if (b.dstPass == execPass.pass)
-                            currentLayouts[b.resource] = b.newLayout;
-                    }
-                }
+            if (auto it = gpuTimings.find(execPass.name); it != gpuTimings.end())
+                timing.gpuMs = it->second;
+        }
 
-                const auto& passInfo = rg.GetPass(execPass.pass);
-                if (passInfo.record)
-                    passInfo.record(cmd, imageViews);
-            }
-        });
+        const RenderGraph& graph = m_FrameGraph->graph;
+        bool dot = std::filesystem::path(m_GraphDumpPath).extension() == ".dot";
 
-        vkWaitForFences(m_Context->GetDevice(), 1, &m_Sync.at(m_FrameIndex).inPresent, VK_TRUE, std::numeric_limits<u64>::max());
-        m_Commands.at(m_FrameIndex)->Submit(
-            { m_Sync.at(m_FrameIndex).imageAvailable },
-            { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT },
-            { m_Sync.at(m_FrameIndex).renderFinished },
-            m_Sync.at(m_FrameIndex).inFlight
+        RenderGraphExporter::WriteFile(m_GraphDumpPath, dot
+            ? RenderGraphExporter::ToDot(graph, m_LastPlan, timings)
+            : RenderGraphExporter::ToJson(graph, m_LastPlan, timings)
         );
+    }
+
+    void Renderer::PaceFrame()
+    {
+        PROFILE_SCOPE("Renderer::PaceFrame")
+
+        // With present wait, block until all but maxQueuedFrames presents are
+        // on screen, which is also when their latency becomes measurable.
+        if (m_FramePacer->IsEnabled() && m_Context->SupportsPresentWait()) {
+            while (m_FramePacer->HasExcessQueuedPresents()) {
+                auto present = m_FramePacer->PopOldestPresent();
+                m_Swapchain->WaitForPresent(present.presentId, s_PresentWaitTimeoutNs);
+                m_FramePacer->RecordPresented(present.inputTimestampNs, Profiler::Now());
+            }
+            return;
+        }
 
-        vkResetFences(m_Context->GetDevice(), 1, &m_Sync.at(m_FrameIndex).inPresent);
-        m_Swapchain->Present(m_Context->GetPresentQueue(), m_Sync.at(m_FrameIndex).renderFinished, m_Sync.at(m_FrameIndex).inPresent);
+        // Otherwise the return from the present call is the closest
+        // CPU-visible signal that does not stall on the present.
+        m_FramePacer->RecordPresented(m_FrameInputNs, Profiler::Now());
+        m_FramePacer->Throttle();
+    }
 
-        vkWaitForFences(m_Context->GetDevice(), 1, &m_Sync.at(m_FrameIndex).inFlight, VK_TRUE, std::numeric_limits<u64>::max());
-        vkWaitForFences(m_Context->GetDevice(), 1, &m_Sync.at(m_FrameIndex).inPresent, VK_TRUE, std::numeric_limits<u64>::max());
+    std::optional<Renderer::Backbuffer> Renderer::AcquireBackbuffer()
+    {
+        if (IsHeadless()) {
+            if (!m_OffscreenTarget->AcquireNextImage())
+                return std::nullopt;
+
+            return Backbuffer {
+                .image = m_OffscreenTarget->GetCurrentImage(),
+                .view = m_OffscreenTarget->GetCurrentImageView(),
+                .extent = m_OffscreenTarget->GetExtent(),
+                .format = m_OffscreenTarget->GetFormat()
+            };
+        }
 
-        m_FrameIndex = (m_FrameIndex + 1) % s_FrameInFlight;
+        m_Swapchain->CollectRetired();
+
+        if (m_SwapchainDirty && !RecreateSwapchain(m_WindowExtent))
+            return std::nullopt;
+
+        auto status = m_Swapchain->AcquireNextImage(m_Sync.at(m_FrameIndex).imageAvailable);
+        if (status == VulkanSwapchain::Status::OutOfDate) {
+            if (!RecreateSwapchain(m_WindowExtent))
+                return std::nullopt;
+
+            status = m_Swapchain->AcquireNextImage(m_Sync.at(m_FrameIndex).imageAvailable);
+        }
+
+        // A suboptimal image is still presentable; recreate on the next frame.
+        if (status == VulkanSwapchain::Status::Suboptimal)
+            m_SwapchainDirty = true;
+        else if (status != VulkanSwapchain::Status::Success)
+            return std::nullopt;
+
+        return Backbuffer {
+            .image = m_Swapchain->GetCurrentImage(),
+            .view = m_Swapchain->GetCurrentImageView(),
+            .extent = m_Swapchain->GetExtent(),
+            .format = m_Swapchain->GetFormat()
+        };
     }
 
     void Renderer::CreateResources()
     {
-        m_Context = CreateRef<VulkanContext>(*m_Window);
+        if (IsHeadless()) {
+            m_Context = CreateRef<VulkanContext>(m_ContextConfig);
+
+            VulkanOffscreenTarget::Config offscreenConfig {
+                .extent = m_HeadlessConfig.extent,
+                .format = m_HeadlessConfig.format
+            };
+            m_OffscreenTarget = CreateScope<VulkanOffscreenTarget>(m_Context, offscreenConfig);
+        } else {
+            m_Context = CreateRef<VulkanContext>(*m_Window, m_ContextConfig);
+
+            // FIFO never discards frames, so every present id reaches the
+            // screen and pacing controls the queue depth instead.
+            VulkanSwapchain::Config swapchainConfig {
+                .extent = m_WindowExtent,
+                .preferredPresentMode = m_FramePacer->IsEnabled() ? VK_PRESENT_MODE_FIFO_KHR : VK_PRESENT_MODE_MAILBOX_KHR
+            };
+            m_Swapchain = CreateScope<VulkanSwapchain>(m_Context, swapchainConfig);
+        }
+
+        // A role that had to share its queue takes a pooled one instead when a
+        // family still has one. Roles that still share a VkQueue share its
+        // submitter as well, so that each queue is guarded by exactly one lock.
+        auto createSubmitter = [this](DeviceQueue queue, VkQueueFlags flags, std::initializer_list<Ref<VulkanQueueSubmitter>> existing) {
+            if (queue.shared) {
+                if (auto pooled = m_Context->AcquireQueue(flags)) {
+                    m_PooledQueues.push_back(pooled.value());
+                    queue = pooled.value();
+                }
+            }
 
-        VulkanSwapchain::Config swapchainConfig {
-            .extent = {
-                .width = m_Window->Width(),
-                .height = m_Window->Height()
+            for (const auto& submitter : existing) {
+                if (submitter->GetQueue().queue == queue.queue)
+                    return submitter;
             }
+
+            return CreateRef<VulkanQueueSubmitter>(m_Context, queue);
         };
-        m_Swapchain = CreateScope<VulkanSwapchain>(m_Context, swapchainConfig);
 
-        for (usize i = 0; i < s_FrameInFlight; ++i)
-            m_Commands.at(i) = CreateScope<VulkanCommandRecorder>(m_Context, m_Context->GetGraphicsDeviceQueue());
+        m_GraphicsSubmitter = CreateRef<VulkanQueueSubmitter>(m_Context, m_Context->GetGraphicsDeviceQueue());
+        m_ComputeSubmitter = createSubmitter(m_Context->GetComputeDeviceQueue(), VK_QUEUE_COMPUTE_BIT, { m_GraphicsSubmitter });
+        m_TransferSubmitter = createSubmitter(m_Context->GetTransferDeviceQueue(), VK_QUEUE_TRANSFER_BIT, { m_GraphicsSubmitter, m_ComputeSubmitter });
+        m_DeletionQueue = CreateRef<VulkanDeletionQueue>();
+
+        m_CommandAllocator = CreateRef<VulkanCommandAllocator>(m_Context, m_Context->GetGraphicsDeviceQueue(), VulkanCommandAllocator::Config {
+            .framesInFlight = static_cast<u32>(s_FrameInFlight),
+            .growthCount = 4
+        });
+        m_Commands = CreateScope<VulkanCommandRecorder>(m_CommandAllocator);
 
-        m_PipelineConfig.shaders.push_back(CreateRef<VulkanShader>(m_Context, "../shaders/triangle.vert.spv", VK_SHADER_STAGE_VERTEX_BIT));
-        m_PipelineConfig.shaders.push_back(CreateRef<VulkanShader>(m_Context, "../shaders/triangle.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT));
+        {
+            std::lock_guard<std::mutex> lock(m_RenderMutex);
+            m_GpuProfiler = CreateScope<VulkanGpuProfiler>(m_Context, VulkanGpuProfiler::Config {
+                .framesInFlight = static_cast<u32>(s_FrameInFlight),
+                .logIntervalFrames = 600
+            });
+        }
+
+        m_FrameCapture = CreateScope<VulkanFrameCapture>(m_Context, VulkanFrameCapture::Config {
+            .ringSize = static_cast<u32>(s_FrameInFlight) + 2
+        });
+
+        m_GraphAllocator = CreateScope<RenderGraphAllocator>(m_Context, m_DeletionQueue);
+        m_DynamicResolution = CreateScope<DynamicResolution>(DynamicResolution::Config {});
+
+        m_ShaderCache = CreateScope<VulkanShaderCache>(m_Context);
+        m_LayoutCache = CreateScope<VulkanLayoutCache>(m_Context);
+        if (std::string archivePath = ShaderArchive::GetDefaultPath(); std::filesystem::exists(archivePath))
+            m_ShaderArchive = CreateScope<ShaderArchive>(archivePath);
+        Ref<VulkanShader> vertexShader = LoadShader("triangle.vert.spv", VK_SHADER_STAGE_VERTEX_BIT);
+        Ref<VulkanShader> fragmentShader = LoadShader("triangle.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT);
+        if (vertexShader && fragmentShader) {
+            m_PipelineConfig.shaders.push_back(vertexShader);
+            m_PipelineConfig.shaders.push_back(fragmentShader);
+        }
         m_PipelineConfig.frontFace = VK_FRONT_FACE_CLOCKWISE;
         m_PipelineConfig.depthTestEnabled = false;
         m_PipelineConfig.depthWriteEnabled = false;
+        m_PipelineConfig.dynamicState = true;
+        // Shader objects are used wherever the device has them, unless the
+        // application turned them off.
+        m_PipelineConfig.shaderObjects = m_ShaderObjects && m_Context->SupportsShaderObject();
         m_PipelineConfig.colorBlendAttachments.push_back(VkPipelineColorBlendAttachmentState {
             .blendEnable = VK_TRUE,
             .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
@@ -282,7 +803,20 @@ namespace Renderer {
             .alphaBlendOp = VK_BLEND_OP_ADD,
             .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
         });
-        m_PipelineConfig.colorAttachmentFormats.push_back(m_Swapchain->GetFormat());
+        m_PipelineConfig.colorAttachmentFormats.push_back(IsHeadless() ? m_OffscreenTarget->GetFormat() : m_Swapchain->GetFormat());
+        m_UpscaleFilter = m_Context->SupportsLinearBlit(m_PipelineConfig.colorAttachmentFormats.at(0)) ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+
+        m_PipelineCompiler = CreateScope<VulkanPipelineCompiler>(m_Context, *m_LayoutCache, VulkanPipelineCompiler::Config {});
+        LOG_INFO("Graphics backend: {}", VulkanGraphicsPipeline::UsesShaderObjects(m_Context, m_PipelineConfig)
+            ? "shader objects"
+            : m_PipelineCompiler->UsesPipelineLibraries() ? "pipeline libraries" : "pipelines")
+        // Without its shaders the triangle pass only clears.
+        if (!m_PipelineConfig.shaders.empty()) {
+            CreateTrianglePipeline();
+        } else {
+            LOG_ERROR("Failed to load the triangle shaders, skipping pipeline creation")
+        }
+        m_DynamicState = CreateScope<VulkanDynamicState>(m_Context);
 
         static constexpr VkSemaphoreCreateInfo semaphoreInfo {
             .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
@@ -307,14 +841,41 @@ namespace Renderer {
 
     void Renderer::DestroyResources()
     {
+        m_FrameCapture->Flush();
+        m_FrameCapture.reset();
+        m_DeletionQueue->Flush();
+        m_FrameGraph.reset();
+        m_Frame = {};
+        m_GraphAllocator.reset();
+
         for (usize i = 0; i < s_FrameInFlight; ++i) {
             vkDestroyFence(m_Context->GetDevice(), m_Sync.at(i).inPresent, nullptr);
             vkDestroyFence(m_Context->GetDevice(), m_Sync.at(i).inFlight, nullptr);
             vkDestroySemaphore(m_Context->GetDevice(), m_Sync.at(i).renderFinished, nullptr);
             vkDestroySemaphore(m_Context->GetDevice(), m_Sync.at(i).imageAvailable, nullptr);
         }
-        for (auto& command : m_Commands)
-            command.reset();
+        m_TransferSubmitter.reset();
+        m_ComputeSubmitter.reset();
+        m_GraphicsSubmitter.reset();
+        for (const auto& queue : m_PooledQueues)
+            m_Context->ReleaseQueue(queue);
+        m_PooledQueues.clear();
+        m_DeletionQueue.reset();
+        m_Commands.reset();
+        m_CommandAllocator.reset();
+        {
+            std::lock_guard<std::mutex> lock(m_RenderMutex);
+            m_GpuProfiler.reset();
+        }
+        m_DynamicState.reset();
+        m_TrianglePipeline.reset();
+        m_TrianglePermutations.reset();
+        m_PipelineCompiler.reset();
+        m_PipelineConfig.shaders.clear();
+        m_ShaderCache.reset();
+        m_LayoutCache.reset();
+        m_ShaderArchive.reset();
+        m_OffscreenTarget.reset();
         m_Swapchain.reset();
         m_Context.reset();
     }
@@ -333,12 +894,74 @@ namespace Renderer {
         if (resize.width == 0 || resize.height == 0)
             return;
 
-        for (usize i = 0; i < s_FrameInFlight; ++i) {
-            vkWaitForFences(m_Context->GetDevice(), 1, &m_Sync.at(i).inFlight, VK_TRUE, std::numeric_limits<u64>::max());
-            vkWaitForFences(m_Context->GetDevice(), 1, &m_Sync.at(i).inPresent, VK_TRUE, std::numeric_limits<u64>::max());
+        if (!IsHeadless()) {
+            m_WindowExtent = VkExtent2D{ resize.width, resize.height };
+            RecreateSwapchain(m_WindowExtent);
+            return;
+        }
+
+        // Frames in flight may still write the old images, so they are
+        // released once the next submission completes.
+        m_OffscreenTarget->Recreate(VkExtent2D{ resize.width, resize.height }, m_DeletionQueue.get());
+    }
+
+    bool Renderer::RecreateSwapchain(VkExtent2D extent)
+    {
+        PROFILE_SCOPE("Renderer::RecreateSwapchain")
+
+        if (!m_Swapchain->Recreate(extent))
+            return false;
+
+        m_SwapchainDirty = false;
+
+        if (m_PipelineConfig.colorAttachmentFormats.at(0) != m_Swapchain->GetFormat()) {
+            m_PipelineConfig.colorAttachmentFormats.at(0) = m_Swapchain->GetFormat();
+            if (m_TrianglePermutations) {
+                m_DeletionQueue->DeferRelease(m_TrianglePermutations);
+                CreateTrianglePipeline();
+            }
         }
+        m_UpscaleFilter = m_Context->SupportsLinearBlit(m_Swapchain->GetFormat()) ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
 
-        m_Swapchain->Recreate(VkExtent2D{ resize.width, resize.height });
+        return true;
+    }
+
+    Ref<VulkanShader> Renderer::LoadShader(const std::string& name, VkShaderStageFlagBits stage)
+    {
+        // Loose files are kept as a fallback for runs from the source tree
+        // without a packed archive.
+        if (m_ShaderArchive && m_ShaderArchive->IsOpen())
+            return m_ShaderCache->Load(*m_ShaderArchive, name, stage);
+
+        return m_ShaderCache->Load(ShaderArchive::GetLooseShaderPath(name), stage);
+    }
+
+    void Renderer::CreateTrianglePipeline()
+    {
+        // The fragment shader encodes to sRGB itself when the attachment
+        // does not, so UNORM swapchains and the headless target match.
+        m_TrianglePermutations = CreateRef<VulkanPipelinePermutations>(*m_PipelineCompiler, m_PipelineConfig);
+        u32 encodeSrgb = m_TrianglePermutations->AddOption({
+            .name = "encodeSrgb",
+            .constantId = 0,
+            .values = { 0, 1 },
+            .stages = VK_SHADER_STAGE_FRAGMENT_BIT
+        });
+
+        VulkanPipelinePermutations::Selection selection = m_TrianglePermutations->GetDefaultSelection();
+        selection.at(encodeSrgb) = IsSrgbFormat(m_PipelineConfig.colorAttachmentFormats.at(0)) ? 0 : 1;
+        m_TrianglePipeline = m_TrianglePermutations->Get(selection);
+    }
+
+    bool Renderer::IsSrgbFormat(VkFormat format)
+    {
+        switch (format) {
+            case VK_FORMAT_R8G8B8A8_SRGB:
+            case VK_FORMAT_B8G8R8A8_SRGB:
+                return true;
+            default:
+                return false;
+        }
     }
 
 }
@@ -1,15 +1,30 @@
 #pragma once
 
 #include <array>
+#include <optional>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 
 #include "Core/Window.hpp"
+#include "Core/ShaderArchive.hpp"
+#include "FramePacer.hpp"
+#include "DynamicResolution.hpp"
+#include "RenderGraphAllocator.hpp"
 #include "Vulkan/VulkanContext.hpp"
 #include "Vulkan/VulkanSwapchain.hpp"
+#include "Vulkan/VulkanOffscreenTarget.hpp"
+#include "Vulkan/VulkanCommandAllocator.hpp"
 #include "Vulkan/VulkanCommandRecorder.hpp"
+#include "Vulkan/VulkanQueueSubmitter.hpp"
+#include "Vulkan/VulkanDeletionQueue.hpp"
+#include "Vulkan/VulkanShaderCache.hpp"
 #include "Vulkan/VulkanGraphicsPipeline.hpp"
+#include "Vulkan/VulkanPipelineCompiler.hpp"
+#include "Vulkan/VulkanPipelinePermutations.hpp"
+#include "Vulkan/VulkanDynamicState.hpp"
+#include "Vulkan/VulkanGpuProfiler.hpp"
+#include "Vulkan/VulkanFrameCapture.hpp"
 
 namespace Renderer {
 
@@ -18,15 +33,69 @@ namespace Renderer {
     public:
         struct RenderPacket
         {
+            i64 inputTimestampNs { 0 };
+        };
+
+        struct FrameStats
+        {
+            u64 frame { 0 };
+            f64 renderMs { 0.0 };
+            f64 presentMs { 0.0 };
+            f64 gpuMs { 0.0 };
+            f32 renderScale { 1.0f };
+        };
+
+        struct ScheduleSummary
+        {
+            ScheduleMode mode { ScheduleMode::Naive };
+            ScheduleStats stats;
+            std::vector<std::string> criticalPath;
+        };
+
+        struct Config
+        {
+            FramePacer::Config pacing;
+            VulkanContext::Config context;
+            bool shaderObjects { true };
+            ScheduleMode schedule { ScheduleMode::Naive };
+            std::string graphDumpPath;
+        };
+
+        struct HeadlessConfig
+        {
+            VkExtent2D extent { 1280, 720 };
+            VkFormat format { VK_FORMAT_R8G8B8A8_UNORM };
+            VulkanContext::Config context;
+            bool shaderObjects { true };
+            ScheduleMode schedule { ScheduleMode::Naive };
+            std::string graphDumpPath;
         };
 
     public:
         Renderer(const Ref<Window>& window);
+        Renderer(const Ref<Window>& window, const Config& config);
+        Renderer(const HeadlessConfig& config);
         ~Renderer();
 
+        inline bool IsHeadless() const { return m_Window == nullptr; }
+
         void RequestResize(u32 width, u32 height);
         void Submit(std::vector<RenderPacket>& packets);
 
+        u64 GetProcessedFrameCount();
+        void WaitForFrame(u64 frame);
+
+        void RequestCapture(const VulkanFrameCapture::Request& request);
+        void SetDynamicResolution(const DynamicResolution::Config& config);
+
+        inline void SetFrameStatsEnabled(bool enabled) { m_FrameStatsEnabled = enabled; }
+        std::vector<FrameStats> ConsumeFrameStats();
+
+        inline FramePacer::LatencyStats GetLatencyStats() const { return m_FramePacer->GetLatencyStats(); }
+
+        std::unordered_map<std::string, VulkanGpuProfiler::ScopeStats> GetGpuStats();
+        ScheduleSummary GetScheduleSummary();
+
     private:
         struct SyncData
         {
@@ -43,14 +112,59 @@ namespace Renderer {
             u32 height { 0 };
         };
 
+        struct Backbuffer
+        {
+            VkImage image { VK_NULL_HANDLE };
+            VkImageView view { VK_NULL_HANDLE };
+            VkExtent2D extent { 0, 0 };
+            VkFormat format { VK_FORMAT_UNDEFINED };
+        };
+
+        struct FrameGraph
+        {
+            RenderGraph graph;
+            VkExtent2D extent { 0, 0 };
+            VkFormat format { VK_FORMAT_UNDEFINED };
+            bool dynamicResolution { false };
+            VkExtent2D sceneExtent { 0, 0 };
+
+            ResourceHandle backbuffer { 0 };
+            ResourceHandle scene { 0 };
+            PassHandle output { 0 };
+            std::optional<PassHandle> capture;
+        };
+
+        // Per-frame state read by the record callbacks of the persistent graph.
+        struct FrameInputs
+        {
+            Backbuffer backbuffer;
+            VkExtent2D renderExtent { 0, 0 };
+            Ref<VulkanGraphicsPipeline> pipeline;
+            std::unordered_map<ResourceHandle, VkImage> images;
+        };
+
     private:
         void RenderThreadLoop();
         void ProcessFrame();
 
+        std::optional<Backbuffer> AcquireBackbuffer();
+
+        void BuildFrameGraph(const Backbuffer& backbuffer);
+        void UpdateCapturePass();
+        PassHandle AddOutputPass();
+        void WriteGraphDump();
+
         void CreateResources();
         void DestroyResources();
 
         void HandleResize();
+        bool RecreateSwapchain(VkExtent2D extent);
+
+        Ref<VulkanShader> LoadShader(const std::string& name, VkShaderStageFlagBits stage);
+        void CreateTrianglePipeline();
+        static bool IsSrgbFormat(VkFormat format);
+
+        void PaceFrame();
 
     private:
         std::atomic<bool> m_Running { true };
@@ -59,22 +173,67 @@ namespace Renderer {
         std::mutex m_RenderMutex;
 
         std::condition_variable m_QueueCondition;
+        std::condition_variable m_FrameCondition;
+        u64 m_ProcessedFrames { 0 };
         std::vector<RenderPacket> m_StagingQueue;
         std::vector<RenderPacket> m_RenderQueue;
 
+        std::atomic<bool> m_FrameStatsEnabled { false };
+        FrameStats m_CurrentFrameStats;
+        std::vector<FrameStats> m_FrameStats;
+
         ResizeRequest m_ResizeRequest;
+        std::optional<VulkanFrameCapture::Request> m_CaptureRequest;
+        std::optional<DynamicResolution::Config> m_ResolutionRequest;
 
         Ref<Window> m_Window;
+        // Render-thread copy of the window size, only updated by resize requests.
+        VkExtent2D m_WindowExtent { 0, 0 };
+        HeadlessConfig m_HeadlessConfig;
+        VulkanContext::Config m_ContextConfig;
+        bool m_ShaderObjects { true };
+        ScheduleMode m_ScheduleMode { ScheduleMode::Naive };
+        ScheduleSummary m_ScheduleSummary;
+        std::string m_GraphDumpPath;
+
+        Scope<FramePacer> m_FramePacer;
+        i64 m_FrameInputNs { 0 };
         
         Ref<VulkanContext> m_Context;
+        Ref<VulkanQueueSubmitter> m_GraphicsSubmitter;
+        Ref<VulkanQueueSubmitter> m_ComputeSubmitter;
+        Ref<VulkanQueueSubmitter> m_TransferSubmitter;
+        std::vector<DeviceQueue> m_PooledQueues;
+        Ref<VulkanDeletionQueue> m_DeletionQueue;
         Scope<VulkanSwapchain> m_Swapchain;
-
+        bool m_SwapchainDirty { false };
+        Scope<VulkanOffscreenTarget> m_OffscreenTarget;
+        Scope<VulkanGpuProfiler> m_GpuProfiler;
+        Scope<VulkanFrameCapture> m_FrameCapture;
+        Scope<RenderGraphAllocator> m_GraphAllocator;
+        Scope<FrameGraph> m_FrameGraph;
+        FrameInputs m_Frame;
+        std::unordered_map<PassHandle, f64> m_PassRecordMs;
+        ExecutionPlan m_LastPlan;
+
+        Scope<DynamicResolution> m_DynamicResolution;
+        VkFilter m_UpscaleFilter { VK_FILTER_LINEAR };
+
+        Scope<ShaderArchive> m_ShaderArchive;
+        Scope<VulkanShaderCache> m_ShaderCache;
+        Scope<VulkanLayoutCache> m_LayoutCache;
+        Scope<VulkanPipelineCompiler> m_PipelineCompiler;
         VulkanGraphicsPipeline::Config m_PipelineConfig;
+        Ref<VulkanPipelinePermutations> m_TrianglePermutations;
+        Ref<VulkanAsyncPipeline> m_TrianglePipeline;
+        Scope<VulkanDynamicState> m_DynamicState;
 
         inline static constexpr usize s_FrameInFlight { 2 };
+        inline static constexpr u64 s_PresentWaitTimeoutNs { 100'000'000 };
 
         usize m_FrameIndex { 0 };
-        std::array<Scope<VulkanCommandRecorder>, s_FrameInFlight> m_Commands;
+        Ref<VulkanCommandAllocator> m_CommandAllocator;
+        Scope<VulkanCommandRecorder> m_Commands;
         std::array<SyncData, s_FrameInFlight> m_Sync;
     };
 
@@ -0,0 +1,131 @@
+#include "VulkanCommandAllocator.hpp"
+
+#include <algorithm>
+
+namespace Renderer {
+
+    VulkanCommandAllocator::VulkanCommandAllocator(const Ref<VulkanContext>& context, const DeviceQueue& queue, const Config& config)
+        : m_Context(context), m_Queue(queue), m_Config(config)
+    {
+        m_Config.framesInFlight = std::max(m_Config.framesInFlight, 1u);
+        m_Config.growthCount = std::max(m_Config.growthCount, 1u);
+    }
+
+    VulkanCommandAllocator::~VulkanCommandAllocator()
+    {
+        for (auto& [_, threadPools] : m_Threads)
+            DestroyPools(*threadPools);
+    }
+
+    void VulkanCommandAllocator::BeginFrame(usize frameSlot)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_FrameSlot = frameSlot % m_Config.framesInFlight;
+        m_FrameCount++;
+
+        // Nothing reports when a recording thread exits, so pools that
+        // have not been used for a whole ring of frames are destroyed; all of
+        // their work has been waited on by then. A thread that comes back
+        // simply creates new pools.
+        std::erase_if(m_Threads, [this](auto& entry) {
+            ThreadPools& threadPools = *entry.second;
+            if (threadPools.lastUsedFrame + m_Config.framesInFlight >= m_FrameCount)
+                return false;
+
+            DestroyPools(threadPools);
+            return true;
+        });
+
+        // The caller has waited for the slot's GPU work, so every buffer
+        // allocated from these pools can be recycled with one reset per pool.
+        for (auto& [_, threadPools] : m_Threads) {
+            std::lock_guard<std::mutex> threadLock(threadPools->mutex);
+
+            Pool& slot = threadPools->slots.at(m_FrameSlot);
+            if (slot.primaryUsed == 0 && slot.secondaryUsed == 0)
+                continue;
+
+            VK_CHECK(vkResetCommandPool(m_Context->GetDevice(), slot.pool, 0));
+            slot.primaryUsed = 0;
+            slot.secondaryUsed = 0;
+        }
+    }
+
+    VkCommandBuffer VulkanCommandAllocator::Allocate(VkCommandBufferLevel level)
+    {
+        usize frameSlot = 0;
+        ThreadPools* threadPools = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            frameSlot = m_FrameSlot;
+            threadPools = &GetThreadPools();
+            threadPools->lastUsedFrame = m_FrameCount;
+        }
+
+        // Only this thread allocates from its pools; the lock orders it
+        // against BeginFrame resetting them from the render thread.
+        std::lock_guard<std::mutex> lock(threadPools->mutex);
+
+        Pool& slot = threadPools->slots.at(frameSlot);
+
+        bool primary = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        auto& buffers = primary ? slot.primary : slot.secondary;
+        usize& used = primary ? slot.primaryUsed : slot.secondaryUsed;
+
+        if (used == buffers.size())
+            Grow(slot, level, buffers);
+
+        return buffers[used++];
+    }
+
+    VulkanCommandAllocator::ThreadPools& VulkanCommandAllocator::GetThreadPools()
+    {
+        auto& threadPools = m_Threads[std::this_thread::get_id()];
+        if (threadPools)
+            return *threadPools;
+
+        threadPools = CreateScope<ThreadPools>();
+        threadPools->slots.resize(m_Config.framesInFlight);
+
+        VkCommandPoolCreateInfo poolInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+            .queueFamilyIndex = m_Queue.index
+        };
+
+        for (auto& slot : threadPools->slots)
+            VK_CHECK(vkCreateCommandPool(m_Context->GetDevice(), &poolInfo, nullptr, &slot.pool));
+
+        return *threadPools;
+    }
+
+    void VulkanCommandAllocator::Grow(Pool& pool, VkCommandBufferLevel level, std::vector<VkCommandBuffer>& buffers)
+    {
+        // Buffers are never freed individually; a reset pool hands the same
+        // handles out again, so the pool only grows to the frame's peak.
+        u32 count = std::max(m_Config.growthCount, static_cast<u32>(buffers.size()));
+
+        VkCommandBufferAllocateInfo allocateInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .pNext = nullptr,
+            .commandPool = pool.pool,
+            .level = level,
+            .commandBufferCount = count
+        };
+
+        usize offset = buffers.size();
+        buffers.resize(offset + count);
+        VK_CHECK(vkAllocateCommandBuffers(m_Context->GetDevice(), &allocateInfo, buffers.data() + offset));
+    }
+
+    void VulkanCommandAllocator::DestroyPools(ThreadPools& threadPools)
+    {
+        for (auto& slot : threadPools.slots) {
+            if (slot.pool != VK_NULL_HANDLE)
+                vkDestroyCommandPool(m_Context->GetDevice(), slot.pool, nullptr);
+        }
+    }
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "VulkanTypes.hpp"
+#include "VulkanContext.hpp"
+
+namespace Renderer {
+
+    class VulkanCommandAllocator
+    {
+    public:
+        struct Config
+        {
+            u32 framesInFlight { 2 };
+            u32 growthCount { 4 };
+        };
+
+    public:
+        VulkanCommandAllocator(const Ref<VulkanContext>& context, const DeviceQueue& queue, const Config& config);
+        ~VulkanCommandAllocator();
+
+        inline usize GetFrameSlot() const { return m_FrameSlot; }
+
+        // Called once the slot's GPU work has completed. Allocate may run on
+        // any thread meanwhile, but a buffer belongs to the slot that was
+        // current when it was allocated and must be submitted before that
+        // slot comes around again.
+        void BeginFrame(usize frameSlot);
+        VkCommandBuffer Allocate(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+    private:
+        struct Pool
+        {
+            VkCommandPool pool { VK_NULL_HANDLE };
+            std::vector<VkCommandBuffer> primary;
+            std::vector<VkCommandBuffer> secondary;
+            usize primaryUsed { 0 };
+            usize secondaryUsed { 0 };
+        };
+
+        struct ThreadPools
+        {
+            std::mutex mutex;
+            std::vector<Pool> slots;
+            u64 lastUsedFrame { 0 };
+        };
+
+    private:
+        ThreadPools& GetThreadPools();
+        void Grow(Pool& pool, VkCommandBufferLevel level, std::vector<VkCommandBuffer>& buffers);
+        void DestroyPools(ThreadPools& threadPools);
+
+    private:
+        Ref<VulkanContext> m_Context;
+        DeviceQueue m_Queue;
+        Config m_Config;
+
+        std::atomic<usize> m_FrameSlot { 0 };
+        u64 m_FrameCount { 0 };
+
+        std::mutex m_Mutex;
+        std::unordered_map<std::thread::id, Scope<ThreadPools>> m_Threads;
+    };
+
+}
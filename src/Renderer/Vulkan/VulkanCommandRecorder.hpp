@@ -1,24 +1,22 @@
 #pragma once
 
 #include "VulkanTypes.hpp"
-#include "VulkanContext.hpp"
+#include "VulkanCommandAllocator.hpp"
 
 namespace Renderer {
 
     class VulkanCommandRecorder
     {
     public:
-        VulkanCommandRecorder(const Ref<VulkanContext>& context, const DeviceQueue& queueFamily);
-        ~VulkanCommandRecorder();
+        VulkanCommandRecorder(const Ref<VulkanCommandAllocator>& allocator);
+
+        inline const VkCommandBuffer& GetCommandBuffer() const { return m_CommandBuffer; }
 
         void Record(const std::function<void(const VkCommandBuffer&)>& task);
-        void Submit(const std::vector<VkSemaphore>& waitSemaphore, const std::vector<VkPipelineStageFlags>& waitStages, const std::vector<VkSemaphore>& signalSemaphores, VkFence& signalFence);
 
     private:
-        Ref<VulkanContext> m_Context;
-        const DeviceQueue& m_QueueFamily;
+        Ref<VulkanCommandAllocator> m_Allocator;
 
-        VkCommandPool m_CommandPool { VK_NULL_HANDLE };
         VkCommandBuffer m_CommandBuffer { VK_NULL_HANDLE };
     };
 
@@ -1,29 +1,157 @@
 #include "VulkanContext.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <vector>
 
 namespace Renderer {
 
     VulkanContext::VulkanContext(Window& window)
+        : VulkanContext(window, Config {})
+    {
+    }
+
+    VulkanContext::VulkanContext(Window& window, const Config& config)
+        : m_Config(config)
+    {
+        Init(&window);
+    }
+
+    VulkanContext::VulkanContext()
+        : VulkanContext(Config {})
+    {
+    }
+
+    VulkanContext::VulkanContext(const Config& config)
+        : m_Config(config)
+    {
+        Init(nullptr);
+    }
+
+    VulkanContext::~VulkanContext()
+    {
+        vkDestroyDevice(m_Device, nullptr);
+        if (m_Surface != VK_NULL_HANDLE)
+            vkDestroySurfaceKHR(m_Instance, m_Surface, nullptr);
+        vkDestroyInstance(m_Instance, nullptr);
+    }
+
+    std::optional<u32> VulkanContext::FindMemoryType(u32 typeBits, VkMemoryPropertyFlags properties) const
+    {
+        for (u32 i = 0; i < m_MemoryProperties.memoryTypeCount; ++i) {
+            if ((typeBits & (1u << i)) && (m_MemoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+                return i;
+        }
+
+        return std::nullopt;
+    }
+
+    bool VulkanContext::SupportsLinearBlit(VkFormat format) const
+    {
+        static constexpr VkFormatFeatureFlags required = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, format, &properties);
+
+        return (properties.optimalTilingFeatures & required) == required;
+    }
+
+    std::optional<DeviceQueue> VulkanContext::AcquireQueue(VkQueueFlags flags)
+    {
+        std::lock_guard<std::mutex> lock(m_WorkerQueueMutex);
+
+        // Prefer the most specialized family, e.g. a transfer-only family for
+        // streaming, so that general-purpose queues stay available.
+        std::optional<usize> best;
+        for (usize i = 0; i < m_WorkerQueues.size(); ++i) {
+            if (m_WorkerQueueInUse[i])
+                continue;
+
+            VkQueueFlags familyFlags = m_QueueFamilies.at(m_WorkerQueues[i].index).queueFlags;
+            if ((familyFlags & flags) != flags)
+                continue;
+
+            if (!best.has_value() || std::popcount(familyFlags) < std::popcount(m_QueueFamilies.at(m_WorkerQueues[best.value()].index).queueFlags))
+                best = i;
+        }
+
+        if (!best.has_value())
+            return std::nullopt;
+
+        m_WorkerQueueInUse[best.value()] = 1;
+        return m_WorkerQueues[best.value()];
+    }
+
+    void VulkanContext::ReleaseQueue(const DeviceQueue& queue)
+    {
+        std::lock_guard<std::mutex> lock(m_WorkerQueueMutex);
+
+        for (usize i = 0; i < m_WorkerQueues.size(); ++i) {
+            if (m_WorkerQueues[i].queue == queue.queue)
+                m_WorkerQueueInUse[i] = 0;
+        }
+    }
+
+    bool VulkanContext::IsDeviceExtensionEnabled(const char* extension) const
+    {
+        return std::any_of(m_EnabledDeviceExtensions.begin(), m_EnabledDeviceExtensions.end(), [extension](const char* enabled) {
+            return std::strcmp(enabled, extension) == 0;
+        });
+    }
+
+    void VulkanContext::Init(Window* window)
     {
 #ifndef NDEBUG
         s_InstanceLayers.push_back("VK_LAYER_KHRONOS_validation");
 #endif
-        s_InstanceExtensions = Window::GetRequiredVulkanExtensions();
+        // The required list is copied so that a headless context does not
+        // drop the swapchain extension for every context created after it.
+        m_EnabledDeviceExtensions = s_DeviceExtensions;
+        if (window != nullptr) {
+            s_InstanceExtensions = Window::GetRequiredVulkanExtensions();
+        } else {
+            s_InstanceExtensions.clear();
+            std::erase_if(m_EnabledDeviceExtensions, [](const char* extension) {
+                return std::strcmp(extension, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0;
+            });
+        }
 
         VK_CHECK(volkInitialize());
+
+        if (window != nullptr) {
+            u32 extensionCount = 0;
+            vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
+            std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+            vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, availableExtensions.data());
+
+            for (const char* extension : s_OptionalPresentInstanceExtensions) {
+                if (HasExtension(availableExtensions, extension))
+                    s_InstanceExtensions.push_back(extension);
+            }
+        }
+
         CreateInstance();
 
-        m_Surface = window.CreateVulkanSurface(m_Instance);
+        if (window != nullptr) {
+            m_Surface = window->CreateVulkanSurface(m_Instance);
+        } else {
+            LOG_INFO("Creating headless Vulkan context")
+        }
 
         PickPhysicalDevice();
         LOG_INFO("Physical device: {}", m_PhysicalDeviceProperties.deviceName)
 
+        vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &m_MemoryProperties);
+
         auto indices = FindQueueFamilies(m_PhysicalDevice, m_Surface);
         m_GraphicsQueue.index = indices.Graphics();
         m_ComputeQueue.index = indices.Compute();
         m_TransferQueue.index = indices.Transfer();
-        m_PresentQueue.index = indices.Present();
+        if (indices.HasPresent())
+            m_PresentQueue.index = indices.Present();
 
         LOG_INFO("Graphics queue family index: {}", m_GraphicsQueue.index)
         LOG_INFO("Compute queue family index: {}", m_ComputeQueue.index)
@@ -33,13 +161,6 @@ namespace Renderer {
         CreateDevice();
     }
 
-    VulkanContext::~VulkanContext()
-    {
-        vkDestroyDevice(m_Device, nullptr);
-        vkDestroySurfaceKHR(m_Instance, m_Surface, nullptr);
-        vkDestroyInstance(m_Instance, nullptr);
-    }
-
     void VulkanContext::CreateInstance()
     {
 #ifndef NDEBUG
@@ -151,7 +272,7 @@ namespace Renderer {
             if (graphicsSupport && !indices.HasGraphics())
                 indices.graphics = index;
 
-            if (graphicsSupport && !indices.HasPresent()) {
+            if (graphicsSupport && !indices.HasPresent() && surface != VK_NULL_HANDLE) {
                 VkBool32 presentSupport = VK_FALSE;
                 vkGetPhysicalDeviceSurfaceSupportKHR(device, index, surface, &presentSupport);
 
@@ -173,7 +294,7 @@ namespace Renderer {
             index += 1;
         }
 
-        if (!indices.HasPresent()) {
+        if (!indices.HasPresent() && surface != VK_NULL_HANDLE) {
             for (usize i = 0; i < families.size(); ++i) {
                 VkBool32 presentSuport = VK_FALSE;
                 vkGetPhysicalDeviceSurfaceSupportKHR(device, static_cast<u32>(i), surface, &presentSuport);
@@ -192,7 +313,7 @@ namespace Renderer {
                 indices.compute = indices.Graphics();
 
             if (!indices.HasTransfer() && (queue.queueFlags & VK_QUEUE_TRANSFER_BIT))
-                indices.transfer = indices.Transfer();
+                indices.transfer = indices.Graphics();
         }
 
         if (!indices.HasCompute() || !indices.HasTransfer()) {
@@ -230,30 +351,200 @@ namespace Renderer {
         std::vector<VkPhysicalDevice> availableDevices(deviceCount);
         vkEnumeratePhysicalDevices(m_Instance, &deviceCount, availableDevices.data());
 
+        std::vector<DeviceCandidate> candidates;
+        candidates.reserve(availableDevices.size());
+
         for (const auto& device : availableDevices) {
-            VkPhysicalDeviceProperties props{};
-            vkGetPhysicalDeviceProperties(device, &props);
+            const auto& candidate = candidates.emplace_back(EvaluatePhysicalDevice(device));
+            if (candidate.suitable) {
+                LOG_INFO("Physical device candidate {} [{}]: score {}", candidate.properties.deviceName, candidate.uuid, candidate.score)
+            } else {
+                LOG_INFO("Physical device candidate {} [{}]: unsuitable", candidate.properties.deviceName, candidate.uuid)
+            }
+        }
 
-            if (props.deviceType != VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
-                continue;
+        std::string deviceOverride = m_Config.deviceOverride;
+        if (deviceOverride.empty()) {
+            if (const char* env = std::getenv("RENDERER_DEVICE"))
+                deviceOverride = env;
+        }
+
+        const DeviceCandidate* selected = nullptr;
+
+        if (!deviceOverride.empty()) {
+            for (const auto& candidate : candidates) {
+                if (!MatchesDeviceOverride(candidate, deviceOverride))
+                    continue;
+
+                if (candidate.suitable) {
+                    selected = &candidate;
+                    break;
+                }
+
+                LOG_WARN("Physical device {} matches {} but is unsuitable", candidate.properties.deviceName, deviceOverride)
+            }
 
-            QueueFamilyIndices indices = FindQueueFamilies(device, m_Surface);
-            if (indices.IsComplete()) {
-                m_PhysicalDevice = device;
-                m_PhysicalDeviceProperties = props;
-                break;
+            if (selected == nullptr) {
+                LOG_WARN("No suitable physical device matches {}, selecting by score", deviceOverride)
             }
         }
 
-        if (m_PhysicalDevice == VK_NULL_HANDLE) {
-            LOG_WARN("Optimal physical device not found. Using fallback selection")
+        if (selected == nullptr) {
+            for (const auto& candidate : candidates) {
+                if (candidate.suitable && (selected == nullptr || candidate.score > selected->score))
+                    selected = &candidate;
+            }
+        }
 
-            m_PhysicalDevice = availableDevices.at(0);
+        if (selected == nullptr) {
+            LOG_WARN("No physical device meets the requirements. Using fallback selection")
+            selected = &candidates.front();
+        }
+
+        m_PhysicalDevice = selected->device;
+        m_PhysicalDeviceProperties = selected->properties;
+    }
+
+    VulkanContext::DeviceCandidate VulkanContext::EvaluatePhysicalDevice(const VkPhysicalDevice& device) const
+    {
+        VkPhysicalDeviceIDProperties idProperties {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES,
+            .pNext = nullptr,
+            .deviceUUID = {},
+            .driverUUID = {},
+            .deviceLUID = {},
+            .deviceNodeMask = 0,
+            .deviceLUIDValid = VK_FALSE
+        };
 
-            VkPhysicalDeviceProperties props{};
-            vkGetPhysicalDeviceProperties(m_PhysicalDevice, &m_PhysicalDeviceProperties);
-            m_PhysicalDeviceProperties = props;
+        VkPhysicalDeviceProperties2 properties {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &idProperties,
+            .properties = VkPhysicalDeviceProperties {}
+        };
+
+        vkGetPhysicalDeviceProperties2(device, &properties);
+
+        DeviceCandidate candidate {
+            .device = device,
+            .properties = properties.properties,
+            .uuid = FormatUuid(idProperties.deviceUUID)
+        };
+
+        QueueFamilyIndices indices = FindQueueFamilies(device, m_Surface);
+        if (!indices.IsComplete(!IsHeadless()))
+            return candidate;
+
+        // Dynamic rendering and synchronization2 are used through their core 1.3 entry points.
+        if (candidate.properties.apiVersion < VK_API_VERSION_1_3)
+            return candidate;
+
+        u32 extensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+        for (const char* extension : m_EnabledDeviceExtensions) {
+            if (!HasExtension(availableExtensions, extension))
+                return candidate;
         }
+
+        VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphore {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
+            .pNext = nullptr,
+            .timelineSemaphore = VK_FALSE
+        };
+
+        VkPhysicalDeviceSynchronization2Features synchronization2 {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES,
+            .pNext = &timelineSemaphore,
+            .synchronization2 = VK_FALSE
+        };
+
+        VkPhysicalDeviceDynamicRenderingFeatures dynamicRendering {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES,
+            .pNext = &synchronization2,
+            .dynamicRendering = VK_FALSE
+        };
+
+        VkPhysicalDeviceFeatures2 features {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &dynamicRendering,
+            .features = VkPhysicalDeviceFeatures {}
+        };
+
+        vkGetPhysicalDeviceFeatures2(device, &features);
+
+        if (dynamicRendering.dynamicRendering != VK_TRUE || synchronization2.synchronization2 != VK_TRUE || timelineSemaphore.timelineSemaphore != VK_TRUE)
+            return candidate;
+
+        candidate.suitable = true;
+
+        // Device type dominates; the rest only orders devices of the same type.
+        switch (candidate.properties.deviceType) {
+            case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   candidate.score += 1'000'000; break;
+            case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: candidate.score += 100'000; break;
+            case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    candidate.score += 10'000; break;
+            default: break;
+        }
+
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(device, &memoryProperties);
+
+        VkDeviceSize deviceLocalBytes = 0;
+        for (u32 i = 0; i < memoryProperties.memoryHeapCount; ++i) {
+            if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+                deviceLocalBytes = std::max(deviceLocalBytes, memoryProperties.memoryHeaps[i].size);
+        }
+
+        candidate.score += deviceLocalBytes / (1024 * 1024);
+
+        if (indices.Compute() != indices.Graphics())
+            candidate.score += 2'000;
+
+        if (indices.Transfer() != indices.Graphics() && indices.Transfer() != indices.Compute())
+            candidate.score += 2'000;
+
+        candidate.score += VK_API_VERSION_MINOR(candidate.properties.apiVersion) * 500;
+
+        if (!IsHeadless()) {
+            for (const char* extension : s_OptionalPresentDeviceExtensions) {
+                if (HasExtension(availableExtensions, extension))
+                    candidate.score += 250;
+            }
+        }
+
+        return candidate;
+    }
+
+    bool VulkanContext::MatchesDeviceOverride(const DeviceCandidate& candidate, std::string_view deviceOverride)
+    {
+        auto normalize = [](std::string_view text, bool stripDashes) {
+            std::string result;
+            for (char c : text) {
+                if (stripDashes && c == '-')
+                    continue;
+                result.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+            }
+            return result;
+        };
+
+        std::string uuid = normalize(candidate.uuid, true);
+        if (normalize(deviceOverride, true) == uuid)
+            return true;
+
+        return normalize(candidate.properties.deviceName, false).find(normalize(deviceOverride, false)) != std::string::npos;
+    }
+
+    std::string VulkanContext::FormatUuid(const u8* uuid)
+    {
+        std::string result;
+        for (u32 i = 0; i < VK_UUID_SIZE; ++i) {
+            if (i == 4 || i == 6 || i == 8 || i == 10)
+                result.push_back('-');
+            result += fmt::format("{:02x}", uuid[i]);
+        }
+        return result;
     }
 
     void VulkanContext::CreateDevice()
@@ -264,7 +555,7 @@ namespace Renderer {
             std::vector<VkExtensionProperties> availableExtensions(extensionCount);
             vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, nullptr, &extensionCount, availableExtensions.data());
 
-            auto it = std::remove_if(s_DeviceExtensions.begin(), s_DeviceExtensions.end(), [&availableExtensions](const char* extension) {
+            auto it = std::remove_if(m_EnabledDeviceExtensions.begin(), m_EnabledDeviceExtensions.end(), [&availableExtensions](const char* extension) {
                 for (const auto& available : availableExtensions) {
                     if (std::strcmp(extension, available.extensionName) == 0)
                         return false;
@@ -274,22 +565,143 @@ namespace Renderer {
                 return true;
             });
 
-            s_DeviceExtensions.erase(it, s_DeviceExtensions.end());
+            m_EnabledDeviceExtensions.erase(it, m_EnabledDeviceExtensions.end());
+
+            // swapchain_maintenance1 depends on the surface_maintenance1
+            // instance extension, which is itself optional.
+            bool surfaceMaintenance1 = std::any_of(s_InstanceExtensions.begin(), s_InstanceExtensions.end(), [](const char* extension) {
+                return std::strcmp(extension, VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME) == 0;
+            });
+
+            if (!IsHeadless()) {
+                for (const char* extension : s_OptionalPresentDeviceExtensions) {
+                    if (std::strcmp(extension, VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME) == 0 && !surfaceMaintenance1)
+                        continue;
+
+                    if (HasExtension(availableExtensions, extension))
+                        m_EnabledDeviceExtensions.push_back(extension);
+                }
+            }
+
+            for (const char* extension : s_OptionalDeviceExtensions) {
+                if (HasExtension(availableExtensions, extension))
+                    m_EnabledDeviceExtensions.push_back(extension);
+            }
         }
 
-        std::vector<VkDeviceQueueCreateInfo> queueInfos;
-        queueInfos.reserve(GetUniqueQueueIndices().size());
+        {
+            VkPhysicalDeviceSwapchainMaintenance1FeaturesKHR supportedMaintenance1 {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SWAPCHAIN_MAINTENANCE_1_FEATURES_KHR,
+                .pNext = nullptr,
+                .swapchainMaintenance1 = VK_FALSE
+            };
+
+            VkPhysicalDevicePresentIdFeaturesKHR supportedPresentId {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+                .pNext = &supportedMaintenance1,
+                .presentId = VK_FALSE
+            };
+
+            VkPhysicalDevicePresentWaitFeaturesKHR supportedPresentWait {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+                .pNext = &supportedPresentId,
+                .presentWait = VK_FALSE
+            };
+
+            VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT supportedPipelineLibrary {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT,
+                .pNext = &supportedPresentWait,
+                .graphicsPipelineLibrary = VK_FALSE
+            };
+
+            VkPhysicalDeviceExtendedDynamicState3FeaturesEXT supportedDynamicState3 {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT,
+                .pNext = &supportedPipelineLibrary,
+                .extendedDynamicState3TessellationDomainOrigin = VK_FALSE,
+                .extendedDynamicState3DepthClampEnable = VK_FALSE,
+                .extendedDynamicState3PolygonMode = VK_FALSE,
+                .extendedDynamicState3RasterizationSamples = VK_FALSE,
+                .extendedDynamicState3SampleMask = VK_FALSE,
+                .extendedDynamicState3AlphaToCoverageEnable = VK_FALSE,
+                .extendedDynamicState3AlphaToOneEnable = VK_FALSE,
+                .extendedDynamicState3LogicOpEnable = VK_FALSE,
+                .extendedDynamicState3ColorBlendEnable = VK_FALSE,
+                .extendedDynamicState3ColorBlendEquation = VK_FALSE,
+                .extendedDynamicState3ColorWriteMask = VK_FALSE,
+                .extendedDynamicState3RasterizationStream = VK_FALSE,
+                .extendedDynamicState3ConservativeRasterizationMode = VK_FALSE,
+                .extendedDynamicState3ExtraPrimitiveOverestimationSize = VK_FALSE,
+                .extendedDynamicState3DepthClipEnable = VK_FALSE,
+                .extendedDynamicState3SampleLocationsEnable = VK_FALSE,
+                .extendedDynamicState3ColorBlendAdvanced = VK_FALSE,
+                .extendedDynamicState3ProvokingVertexMode = VK_FALSE,
+                .extendedDynamicState3LineRasterizationMode = VK_FALSE,
+                .extendedDynamicState3LineStippleEnable = VK_FALSE,
+                .extendedDynamicState3DepthClipNegativeOneToOne = VK_FALSE,
+                .extendedDynamicState3ViewportWScalingEnable = VK_FALSE,
+                .extendedDynamicState3ViewportSwizzle = VK_FALSE,
+                .extendedDynamicState3CoverageToColorEnable = VK_FALSE,
+                .extendedDynamicState3CoverageToColorLocation = VK_FALSE,
+                .extendedDynamicState3CoverageModulationMode = VK_FALSE,
+                .extendedDynamicState3CoverageModulationTableEnable = VK_FALSE,
+                .extendedDynamicState3CoverageModulationTable = VK_FALSE,
+                .extendedDynamicState3CoverageReductionMode = VK_FALSE,
+                .extendedDynamicState3RepresentativeFragmentTestEnable = VK_FALSE,
+                .extendedDynamicState3ShadingRateImageEnable = VK_FALSE
+            };
+
+            VkPhysicalDeviceShaderObjectFeaturesEXT supportedShaderObject {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT,
+                .pNext = &supportedDynamicState3,
+                .shaderObject = VK_FALSE
+            };
+
+            VkPhysicalDeviceFeatures2 supportedFeatures {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                .pNext = &supportedShaderObject,
+                .features = VkPhysicalDeviceFeatures {}
+            };
+
+            vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &supportedFeatures);
+
+            m_SwapchainMaintenance1 = IsDeviceExtensionEnabled(VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME)
+                && supportedMaintenance1.swapchainMaintenance1 == VK_TRUE;
+
+            // Pacing needs both: ids tag presents, wait blocks on them.
+            m_PresentWait = IsDeviceExtensionEnabled(VK_KHR_PRESENT_ID_EXTENSION_NAME)
+                && IsDeviceExtensionEnabled(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)
+                && supportedPresentId.presentId == VK_TRUE
+                && supportedPresentWait.presentWait == VK_TRUE;
+
+            m_GraphicsPipelineLibrary = IsDeviceExtensionEnabled(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME)
+                && IsDeviceExtensionEnabled(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME)
+                && supportedPipelineLibrary.graphicsPipelineLibrary == VK_TRUE;
+
+            // Only the states pipelines actually leave dynamic are required.
+            m_ExtendedDynamicState3 = IsDeviceExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)
+                && supportedDynamicState3.extendedDynamicState3PolygonMode == VK_TRUE
+                && supportedDynamicState3.extendedDynamicState3ColorBlendEnable == VK_TRUE
+                && supportedDynamicState3.extendedDynamicState3ColorBlendEquation == VK_TRUE
+                && supportedDynamicState3.extendedDynamicState3ColorWriteMask == VK_TRUE;
+
+            m_ShaderObject = IsDeviceExtensionEnabled(VK_EXT_SHADER_OBJECT_EXTENSION_NAME)
+                && supportedShaderObject.shaderObject == VK_TRUE;
+        }
+
+        std::map<u32, std::vector<f32>> queuePriorities;
+        PlanDeviceQueues(queuePriorities);
 
-        for (u32 i : GetUniqueQueueIndices()) {
-            static f32 priority[] = { 1.0f };
+        std::vector<VkDeviceQueueCreateInfo> queueInfos;
+        queueInfos.reserve(queuePriorities.size());
 
+        for (const auto& [family, priorities] : queuePriorities) {
             queueInfos.emplace_back(VkDeviceQueueCreateInfo{
                 .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
                 .pNext = nullptr,
                 .flags = 0,
-                .queueFamilyIndex = i,
-                .queueCount = 1,
-                .pQueuePriorities = priority
+                .queueFamilyIndex = family,
+                .queueCount = static_cast<u32>(priorities.size()),
+                .pQueuePriorities = priorities.data()
             });
         }
 
@@ -299,9 +711,105 @@ namespace Renderer {
             .swapchainMaintenance1 = VK_TRUE
         };
 
+        VkPhysicalDevicePresentIdFeaturesKHR presentId {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+            .pNext = nullptr,
+            .presentId = VK_TRUE
+        };
+
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWait {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+            .pNext = &presentId,
+            .presentWait = VK_TRUE
+        };
+
+        VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT pipelineLibrary {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT,
+            .pNext = nullptr,
+            .graphicsPipelineLibrary = VK_TRUE
+        };
+
+        VkPhysicalDeviceExtendedDynamicState3FeaturesEXT dynamicState3 {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT,
+            .pNext = nullptr,
+            .extendedDynamicState3TessellationDomainOrigin = VK_FALSE,
+            .extendedDynamicState3DepthClampEnable = VK_FALSE,
+            .extendedDynamicState3PolygonMode = VK_TRUE,
+            .extendedDynamicState3RasterizationSamples = VK_FALSE,
+            .extendedDynamicState3SampleMask = VK_FALSE,
+            .extendedDynamicState3AlphaToCoverageEnable = VK_FALSE,
+            .extendedDynamicState3AlphaToOneEnable = VK_FALSE,
+            .extendedDynamicState3LogicOpEnable = VK_FALSE,
+            .extendedDynamicState3ColorBlendEnable = VK_TRUE,
+            .extendedDynamicState3ColorBlendEquation = VK_TRUE,
+            .extendedDynamicState3ColorWriteMask = VK_TRUE,
+            .extendedDynamicState3RasterizationStream = VK_FALSE,
+            .extendedDynamicState3ConservativeRasterizationMode = VK_FALSE,
+            .extendedDynamicState3ExtraPrimitiveOverestimationSize = VK_FALSE,
+            .extendedDynamicState3DepthClipEnable = VK_FALSE,
+            .extendedDynamicState3SampleLocationsEnable = VK_FALSE,
+            .extendedDynamicState3ColorBlendAdvanced = VK_FALSE,
+            .extendedDynamicState3ProvokingVertexMode = VK_FALSE,
+            .extendedDynamicState3LineRasterizationMode = VK_FALSE,
+            .extendedDynamicState3LineStippleEnable = VK_FALSE,
+            .extendedDynamicState3DepthClipNegativeOneToOne = VK_FALSE,
+            .extendedDynamicState3ViewportWScalingEnable = VK_FALSE,
+            .extendedDynamicState3ViewportSwizzle = VK_FALSE,
+            .extendedDynamicState3CoverageToColorEnable = VK_FALSE,
+            .extendedDynamicState3CoverageToColorLocation = VK_FALSE,
+            .extendedDynamicState3CoverageModulationMode = VK_FALSE,
+            .extendedDynamicState3CoverageModulationTableEnable = VK_FALSE,
+            .extendedDynamicState3CoverageModulationTable = VK_FALSE,
+            .extendedDynamicState3CoverageReductionMode = VK_FALSE,
+            .extendedDynamicState3RepresentativeFragmentTestEnable = VK_FALSE,
+            .extendedDynamicState3ShadingRateImageEnable = VK_FALSE
+        };
+
+        VkPhysicalDeviceShaderObjectFeaturesEXT shaderObject {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT,
+            .pNext = nullptr,
+            .shaderObject = VK_TRUE
+        };
+
+        void* optionalFeatures = nullptr;
+        if (m_PresentWait)
+            optionalFeatures = &presentWait;
+
+        if (m_GraphicsPipelineLibrary) {
+            pipelineLibrary.pNext = optionalFeatures;
+            optionalFeatures = &pipelineLibrary;
+        }
+
+        if (m_ExtendedDynamicState3) {
+            dynamicState3.pNext = optionalFeatures;
+            optionalFeatures = &dynamicState3;
+        }
+
+        if (m_ShaderObject) {
+            shaderObject.pNext = optionalFeatures;
+            optionalFeatures = &shaderObject;
+        }
+
+        if (m_SwapchainMaintenance1) {
+            swapchainMaintenance1.pNext = optionalFeatures;
+            optionalFeatures = &swapchainMaintenance1;
+        }
+
+        VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphore {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
+            .pNext = optionalFeatures,
+            .timelineSemaphore = VK_TRUE
+        };
+
+        VkPhysicalDeviceSynchronization2Features synchronization2 {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES,
+            .pNext = &timelineSemaphore,
+            .synchronization2 = VK_TRUE
+        };
+
         VkPhysicalDeviceDynamicRenderingFeatures dynamicRendering {
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES,
-            .pNext = &swapchainMaintenance1,
+            .pNext = &synchronization2,
             .dynamicRendering = VK_TRUE
         };
 
@@ -319,25 +827,104 @@ namespace Renderer {
             .pQueueCreateInfos = queueInfos.data(),
             .enabledLayerCount = 0,
             .ppEnabledLayerNames = nullptr,
-            .enabledExtensionCount = static_cast<u32>(s_DeviceExtensions.size()),
-            .ppEnabledExtensionNames = s_DeviceExtensions.data(),
+            .enabledExtensionCount = static_cast<u32>(m_EnabledDeviceExtensions.size()),
+            .ppEnabledExtensionNames = m_EnabledDeviceExtensions.data(),
             .pEnabledFeatures = nullptr
         };
 
         VK_CHECK(vkCreateDevice(m_PhysicalDevice, &createInfo, nullptr, &m_Device));
         volkLoadDevice(m_Device);
 
-        vkGetDeviceQueue(m_Device, m_GraphicsQueue.index, 0, &m_GraphicsQueue.queue);
-        vkGetDeviceQueue(m_Device, m_ComputeQueue.index, 0, &m_ComputeQueue.queue);
-        vkGetDeviceQueue(m_Device, m_TransferQueue.index, 0, &m_TransferQueue.queue);
-        vkGetDeviceQueue(m_Device, m_PresentQueue.index, 0, &m_PresentQueue.queue);
+        vkGetDeviceQueue(m_Device, m_GraphicsQueue.index, m_GraphicsQueue.queueIndex, &m_GraphicsQueue.queue);
+        vkGetDeviceQueue(m_Device, m_ComputeQueue.index, m_ComputeQueue.queueIndex, &m_ComputeQueue.queue);
+        vkGetDeviceQueue(m_Device, m_TransferQueue.index, m_TransferQueue.queueIndex, &m_TransferQueue.queue);
+        if (m_PresentQueue.index != std::numeric_limits<u32>::max())
+            vkGetDeviceQueue(m_Device, m_PresentQueue.index, m_PresentQueue.queueIndex, &m_PresentQueue.queue);
+
+        for (auto& worker : m_WorkerQueues)
+            vkGetDeviceQueue(m_Device, worker.index, worker.queueIndex, &worker.queue);
 
 #ifndef NDEBUG
         LOG_INFO("Device extensions:")
-        for (const auto& extension : s_DeviceExtensions) {
+        for (const auto& extension : m_EnabledDeviceExtensions) {
             LOG_INFO(" - {}", extension)
         }
 #endif
     }
 
+    void VulkanContext::PlanDeviceQueues(std::map<u32, std::vector<f32>>& priorities)
+    {
+        u32 familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &familyCount, nullptr);
+        m_QueueFamilies.resize(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &familyCount, m_QueueFamilies.data());
+
+        auto familyLimit = [this](u32 family) {
+            return std::max(1u, std::min(m_QueueFamilies.at(family).queueCount, m_Config.maxQueuesPerFamily));
+        };
+
+        // Each role gets its own queue while the family has one left, and
+        // otherwise shares the family's last queue at the higher priority.
+        auto assign = [&](DeviceQueue& role, f32 priority) {
+            auto& familyPriorities = priorities[role.index];
+
+            if (familyPriorities.size() < familyLimit(role.index)) {
+                role.queueIndex = static_cast<u32>(familyPriorities.size());
+                familyPriorities.push_back(priority);
+            } else {
+                role.queueIndex = static_cast<u32>(familyPriorities.size() - 1);
+                familyPriorities.back() = std::max(familyPriorities.back(), priority);
+            }
+        };
+
+        assign(m_GraphicsQueue, m_Config.graphicsQueuePriority);
+        assign(m_ComputeQueue, m_Config.computeQueuePriority);
+        assign(m_TransferQueue, m_Config.transferQueuePriority);
+
+        // Presentation is submitted from the render thread, so it rides on the
+        // graphics queue whenever the family allows it.
+        if (m_PresentQueue.index == m_GraphicsQueue.index)
+            m_PresentQueue.queueIndex = m_GraphicsQueue.queueIndex;
+        else if (m_PresentQueue.index != std::numeric_limits<u32>::max())
+            assign(m_PresentQueue, m_Config.graphicsQueuePriority);
+
+        std::vector<DeviceQueue*> roles { &m_GraphicsQueue, &m_ComputeQueue, &m_TransferQueue };
+        if (m_PresentQueue.index != std::numeric_limits<u32>::max())
+            roles.push_back(&m_PresentQueue);
+
+        for (DeviceQueue* role : roles) {
+            role->priority = priorities.at(role->index).at(role->queueIndex);
+            role->shared = std::count_if(roles.begin(), roles.end(), [role](const DeviceQueue* other) {
+                return other->index == role->index && other->queueIndex == role->queueIndex;
+            }) > 1;
+        }
+
+        // Every family is filled up to its limit; queues the roles did not
+        // take are pooled for worker threads.
+        m_WorkerQueues.clear();
+        for (auto& [family, familyPriorities] : priorities) {
+            while (familyPriorities.size() < familyLimit(family)) {
+                DeviceQueue worker {};
+                worker.index = family;
+                worker.queueIndex = static_cast<u32>(familyPriorities.size());
+                worker.priority = m_Config.workerQueuePriority;
+                m_WorkerQueues.push_back(worker);
+                familyPriorities.push_back(m_Config.workerQueuePriority);
+            }
+        }
+        m_WorkerQueueInUse.assign(m_WorkerQueues.size(), 0);
+
+        LOG_INFO("Graphics queue {}.{} (priority {:.2f}{})", m_GraphicsQueue.index, m_GraphicsQueue.queueIndex, m_GraphicsQueue.priority, m_GraphicsQueue.shared ? ", shared" : "")
+        LOG_INFO("Compute queue {}.{} (priority {:.2f}{})", m_ComputeQueue.index, m_ComputeQueue.queueIndex, m_ComputeQueue.priority, m_ComputeQueue.shared ? ", shared" : "")
+        LOG_INFO("Transfer queue {}.{} (priority {:.2f}{})", m_TransferQueue.index, m_TransferQueue.queueIndex, m_TransferQueue.priority, m_TransferQueue.shared ? ", shared" : "")
+        LOG_INFO("Worker queues: {}", m_WorkerQueues.size())
+    }
+
+    bool VulkanContext::HasExtension(const std::vector<VkExtensionProperties>& available, const char* extension)
+    {
+        return std::any_of(available.begin(), available.end(), [extension](const VkExtensionProperties& properties) {
+            return std::strcmp(properties.extensionName, extension) == 0;
+        });
+    }
+
 }
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <map>
+#include <mutex>
 #include <optional>
 #include <set>
+#include <string>
+#include <string_view>
 
 #include "VulkanTypes.hpp"
 #include "Core/Window.hpp"
@@ -12,14 +16,37 @@ namespace Renderer {
     {
         u32 index { std::numeric_limits<u32>::max() };
         VkQueue queue { VK_NULL_HANDLE };
+        u32 queueIndex { 0 };
+        f32 priority { 1.0f };
+        bool shared { false };
     };
 
     class VulkanContext
     {
+    public:
+        struct Config
+        {
+            std::string deviceOverride;
+
+            u32 maxQueuesPerFamily { 4 };
+            f32 graphicsQueuePriority { 1.0f };
+            f32 computeQueuePriority { 0.5f };
+            f32 transferQueuePriority { 0.25f };
+            f32 workerQueuePriority { 0.5f };
+        };
+
     public:
         VulkanContext(Window& window);
+        VulkanContext(Window& window, const Config& config);
+        VulkanContext();
+        VulkanContext(const Config& config);
         ~VulkanContext();
 
+        inline bool IsHeadless() const
+        {
+            return m_Surface == VK_NULL_HANDLE;
+        }
+
         inline const VkInstance& GetInstance() const
         {
             return m_Instance;
@@ -38,6 +65,10 @@ namespace Renderer {
         {
             return m_PhysicalDeviceProperties;
         }
+        inline const VkPhysicalDeviceMemoryProperties& GetMemoryProperties() const
+        {
+            return m_MemoryProperties;
+        }
 
         inline const DeviceQueue& GetGraphicsDeviceQueue() const
         {
@@ -117,12 +148,12 @@ namespace Renderer {
 
         inline std::set<u32> GetUniqueQueueIndices() const
         {
-            return std::set<u32> {
-                m_GraphicsQueue.index,
-                m_ComputeQueue.index,
-                m_TransferQueue.index,
-                m_PresentQueue.index
-            };
+            std::set<u32> indices;
+            for (const auto* queue : { &m_GraphicsQueue, &m_ComputeQueue, &m_TransferQueue, &m_PresentQueue }) {
+                if (queue->index != std::numeric_limits<u32>::max())
+                    indices.insert(queue->index);
+            }
+            return indices;
         }
 
         inline const VkDevice& GetDevice() const
@@ -130,6 +161,41 @@ namespace Renderer {
             return m_Device;
         }
 
+        // Hands out the family's queues beyond the fixed roles, for threads
+        // that submit on their own instead of through a shared submitter.
+        std::optional<DeviceQueue> AcquireQueue(VkQueueFlags flags);
+        void ReleaseQueue(const DeviceQueue& queue);
+
+        bool IsDeviceExtensionEnabled(const char* extension) const;
+
+        inline bool SupportsSwapchainMaintenance1() const
+        {
+            return m_SwapchainMaintenance1;
+        }
+
+        inline bool SupportsPresentWait() const
+        {
+            return m_PresentWait;
+        }
+
+        inline bool SupportsGraphicsPipelineLibrary() const
+        {
+            return m_GraphicsPipelineLibrary;
+        }
+
+        inline bool SupportsExtendedDynamicState3() const
+        {
+            return m_ExtendedDynamicState3;
+        }
+
+        inline bool SupportsShaderObject() const
+        {
+            return m_ShaderObject;
+        }
+
+        std::optional<u32> FindMemoryType(u32 typeBits, VkMemoryPropertyFlags properties) const;
+        bool SupportsLinearBlit(VkFormat format) const;
+
     private:
         struct QueueFamilyIndices
         {
@@ -148,9 +214,9 @@ namespace Renderer {
             inline bool HasTransfer() const { return transfer.has_value(); }
             inline bool HasPresent() const { return present.has_value(); }
 
-            inline bool IsComplete() const
+            inline bool IsComplete(bool requirePresent) const
             {
-                return HasGraphics() && HasCompute() && HasTransfer() && HasPresent();
+                return HasGraphics() && HasCompute() && HasTransfer() && (HasPresent() || !requirePresent);
             }
 
             inline void Reset()
@@ -172,33 +238,83 @@ namespace Renderer {
             }
         };
 
+        struct DeviceCandidate
+        {
+            VkPhysicalDevice device { VK_NULL_HANDLE };
+            VkPhysicalDeviceProperties properties {};
+            std::string uuid;
+            bool suitable { false };
+            u64 score { 0 };
+        };
+
     private:
+        void Init(Window* window);
         void CreateInstance();
 
         static QueueFamilyIndices FindQueueFamilies(const VkPhysicalDevice& device, const VkSurfaceKHR& surface);
         void PickPhysicalDevice();
+        DeviceCandidate EvaluatePhysicalDevice(const VkPhysicalDevice& device) const;
+        static bool MatchesDeviceOverride(const DeviceCandidate& candidate, std::string_view deviceOverride);
+        static std::string FormatUuid(const u8* uuid);
 
         void CreateDevice();
+        void PlanDeviceQueues(std::map<u32, std::vector<f32>>& priorities);
+
+        static bool HasExtension(const std::vector<VkExtensionProperties>& available, const char* extension);
 
     private:
         inline static std::vector<const char*> s_InstanceLayers;
         inline static std::vector<const char*> s_InstanceExtensions;
-        inline static std::vector<const char*> s_DeviceExtensions {
+        inline static const std::vector<const char*> s_DeviceExtensions {
             VK_KHR_SWAPCHAIN_EXTENSION_NAME
         };
 
+        // Enabled when available, only for contexts that present.
+        inline static const std::vector<const char*> s_OptionalPresentInstanceExtensions {
+            VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME,
+            VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME
+        };
+        inline static const std::vector<const char*> s_OptionalPresentDeviceExtensions {
+            VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME,
+            VK_KHR_PRESENT_ID_EXTENSION_NAME,
+            VK_KHR_PRESENT_WAIT_EXTENSION_NAME
+        };
+
+        // Enabled when available.
+        inline static const std::vector<const char*> s_OptionalDeviceExtensions {
+            VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
+            VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
+            VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME,
+            VK_EXT_SHADER_OBJECT_EXTENSION_NAME
+        };
+
+        Config m_Config;
+
         VkInstance m_Instance { VK_NULL_HANDLE };
         VkSurfaceKHR m_Surface { VK_NULL_HANDLE };
 
         VkPhysicalDevice m_PhysicalDevice { VK_NULL_HANDLE };
         VkPhysicalDeviceProperties m_PhysicalDeviceProperties;
+        VkPhysicalDeviceMemoryProperties m_MemoryProperties {};
 
         DeviceQueue m_GraphicsQueue;
         DeviceQueue m_ComputeQueue;
         DeviceQueue m_TransferQueue;
         DeviceQueue m_PresentQueue;
 
+        std::vector<VkQueueFamilyProperties> m_QueueFamilies;
+        std::vector<DeviceQueue> m_WorkerQueues;
+        std::vector<char> m_WorkerQueueInUse;
+        std::mutex m_WorkerQueueMutex;
+
         VkDevice m_Device { VK_NULL_HANDLE };
+        std::vector<const char*> m_EnabledDeviceExtensions;
+
+        bool m_SwapchainMaintenance1 { false };
+        bool m_PresentWait { false };
+        bool m_GraphicsPipelineLibrary { false };
+        bool m_ExtendedDynamicState3 { false };
+        bool m_ShaderObject { false };
     };
 
 }
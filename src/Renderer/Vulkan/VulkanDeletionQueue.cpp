@@ -0,0 +1,77 @@
+#include "VulkanDeletionQueue.hpp"
+
+#include <algorithm>
+
+namespace Renderer {
+
+    VulkanDeletionQueue::~VulkanDeletionQueue()
+    {
+        Flush();
+    }
+
+    void VulkanDeletionQueue::Enqueue(u64 value, Deleter deleter)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Entries.push_back(Entry { .value = value, .deleter = std::move(deleter) });
+    }
+
+    void VulkanDeletionQueue::Defer(Deleter deleter)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Deferred.push_back(std::move(deleter));
+    }
+
+    void VulkanDeletionQueue::Retire(u64 value)
+    {
+        // Deferred objects were last used by work that has not been submitted
+        // yet; the caller passes the timeline value of that submission.
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (auto& deleter : m_Deferred)
+            m_Entries.push_back(Entry { .value = value, .deleter = std::move(deleter) });
+        m_Deferred.clear();
+    }
+
+    usize VulkanDeletionQueue::Collect(u64 completedValue)
+    {
+        std::vector<Deleter> ready;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            auto split = std::stable_partition(m_Entries.begin(), m_Entries.end(), [completedValue](const Entry& entry) {
+                return entry.value <= completedValue;
+            });
+
+            ready.reserve(static_cast<usize>(split - m_Entries.begin()));
+            for (auto it = m_Entries.begin(); it != split; ++it)
+                ready.push_back(std::move(it->deleter));
+            m_Entries.erase(m_Entries.begin(), split);
+        }
+
+        for (auto& deleter : ready)
+            deleter();
+
+        return ready.size();
+    }
+
+    void VulkanDeletionQueue::Flush()
+    {
+        std::vector<Entry> entries;
+        std::vector<Deleter> deferred;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            entries.swap(m_Entries);
+            deferred.swap(m_Deferred);
+        }
+
+        for (auto& entry : entries)
+            entry.deleter();
+        for (auto& deleter : deferred)
+            deleter();
+    }
+
+    usize VulkanDeletionQueue::GetPendingCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Entries.size() + m_Deferred.size();
+    }
+
+}
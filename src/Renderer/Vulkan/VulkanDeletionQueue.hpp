@@ -0,0 +1,50 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "VulkanTypes.hpp"
+
+namespace Renderer {
+
+    class VulkanDeletionQueue
+    {
+    public:
+        using Deleter = std::function<void()>;
+
+    public:
+        VulkanDeletionQueue() = default;
+        ~VulkanDeletionQueue();
+
+        void Enqueue(u64 value, Deleter deleter);
+        void Defer(Deleter deleter);
+        void Retire(u64 value);
+
+        // Holds a reference until the next retired submission has finished,
+        // so work already recorded against the object can still use it.
+        template<typename T>
+        void DeferRelease(Ref<T> object)
+        {
+            Defer([released = std::move(object)]() {});
+        }
+
+        usize Collect(u64 completedValue);
+        void Flush();
+
+        usize GetPendingCount() const;
+
+    private:
+        struct Entry
+        {
+            u64 value { 0 };
+            Deleter deleter;
+        };
+
+    private:
+        mutable std::mutex m_Mutex;
+        std::vector<Entry> m_Entries;
+        std::vector<Deleter> m_Deferred;
+    };
+
+}
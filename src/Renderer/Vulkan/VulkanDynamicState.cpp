@@ -0,0 +1,243 @@
+#include "VulkanDynamicState.hpp"
+
+#include <algorithm>
+
+namespace Renderer {
+
+    namespace {
+
+        bool operator==(const VkViewport& a, const VkViewport& b)
+        {
+            return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height
+                && a.minDepth == b.minDepth && a.maxDepth == b.maxDepth;
+        }
+
+        bool operator==(const VkRect2D& a, const VkRect2D& b)
+        {
+            return a.offset.x == b.offset.x && a.offset.y == b.offset.y
+                && a.extent.width == b.extent.width && a.extent.height == b.extent.height;
+        }
+
+        bool operator==(const VkPipelineColorBlendAttachmentState& a, const VkPipelineColorBlendAttachmentState& b)
+        {
+            return a.blendEnable == b.blendEnable
+                && a.srcColorBlendFactor == b.srcColorBlendFactor
+                && a.dstColorBlendFactor == b.dstColorBlendFactor
+                && a.colorBlendOp == b.colorBlendOp
+                && a.srcAlphaBlendFactor == b.srcAlphaBlendFactor
+                && a.dstAlphaBlendFactor == b.dstAlphaBlendFactor
+                && a.alphaBlendOp == b.alphaBlendOp
+                && a.colorWriteMask == b.colorWriteMask;
+        }
+
+        template <typename T>
+        bool Equal(const T& a, const T& b)
+        {
+            return a == b;
+        }
+
+        template <typename T>
+        bool Equal(const std::vector<T>& a, std::span<const T> b)
+        {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const T& x, const T& y) { return x == y; });
+        }
+
+        template <typename T>
+        T Store(const T& value)
+        {
+            return value;
+        }
+
+        template <typename T>
+        std::vector<T> Store(std::span<const T> value)
+        {
+            return std::vector<T>(value.begin(), value.end());
+        }
+
+    }
+
+    VulkanDynamicState::VulkanDynamicState(const Ref<VulkanContext>& context)
+        : m_Context(context)
+    {
+    }
+
+    void VulkanDynamicState::Reset()
+    {
+        m_BoundPipeline = VK_NULL_HANDLE;
+        m_BoundShaderPipeline = nullptr;
+        m_BoundDynamic = false;
+        m_Viewport.reset();
+        m_Scissor.reset();
+        m_Extended = {};
+        m_Stats = {};
+    }
+
+    void VulkanDynamicState::BindPipeline(const VkCommandBuffer& cmd, const VulkanGraphicsPipeline& pipeline)
+    {
+        // Configs share shader objects but not the state bound with them, so
+        // those are told apart by the pipeline itself.
+        const VulkanGraphicsPipeline* shaderPipeline = pipeline.UsesShaderObjects() ? &pipeline : nullptr;
+        if (pipeline.GetPipeline() == m_BoundPipeline && shaderPipeline == m_BoundShaderPipeline) {
+            ++m_Stats.skipped;
+            return;
+        }
+
+        pipeline.Bind(cmd);
+        ++m_Stats.issued;
+
+        // Shader objects set viewport and scissor along with their counts,
+        // which pipelines do not, so neither carries over between the two.
+        if ((shaderPipeline != nullptr) != (m_BoundShaderPipeline != nullptr)) {
+            m_Viewport.reset();
+            m_Scissor.reset();
+        }
+
+        m_BoundPipeline = pipeline.GetPipeline();
+        m_BoundShaderPipeline = shaderPipeline;
+        m_BoundDynamic = pipeline.HasDynamicState();
+
+        // Binding a pipeline that bakes a state leaves that state undefined
+        // for later pipelines which treat it as dynamic.
+        if (!m_BoundDynamic) {
+            m_Extended = {};
+        } else if (!m_BoundShaderPipeline && !m_Context->SupportsExtendedDynamicState3()) {
+            m_Extended.polygonMode.reset();
+            m_Extended.colorBlend.reset();
+        }
+    }
+
+    void VulkanDynamicState::Apply(const VkCommandBuffer& cmd, const VulkanGraphicsPipeline::Config& cfg)
+    {
+        if (!m_BoundDynamic)
+            return;
+
+        SetCullMode(cmd, cfg.cullMode);
+        SetFrontFace(cmd, cfg.frontFace);
+        SetPrimitiveTopology(cmd, cfg.topology);
+        SetPrimitiveRestartEnable(cmd, false);
+        SetDepthTestEnable(cmd, cfg.depthTestEnabled);
+        SetDepthWriteEnable(cmd, cfg.depthWriteEnabled);
+        SetDepthCompareOp(cmd, cfg.depthCompareOp);
+
+        // Shader objects have no pipeline to fall back on for these.
+        if (m_BoundShaderPipeline || m_Context->SupportsExtendedDynamicState3()) {
+            SetPolygonMode(cmd, cfg.polygonMode);
+            SetColorBlend(cmd, cfg.colorBlendAttachments);
+        }
+    }
+
+    void VulkanDynamicState::SetViewport(const VkCommandBuffer& cmd, const VkViewport& viewport)
+    {
+        if (!Update(m_Viewport, viewport))
+            return;
+
+        if (m_BoundShaderPipeline)
+            vkCmdSetViewportWithCount(cmd, 1, &viewport);
+        else
+            vkCmdSetViewport(cmd, 0, 1, &viewport);
+    }
+
+    void VulkanDynamicState::SetScissor(const VkCommandBuffer& cmd, const VkRect2D& scissor)
+    {
+        if (!Update(m_Scissor, scissor))
+            return;
+
+        if (m_BoundShaderPipeline)
+            vkCmdSetScissorWithCount(cmd, 1, &scissor);
+        else
+            vkCmdSetScissor(cmd, 0, 1, &scissor);
+    }
+
+    void VulkanDynamicState::SetCullMode(const VkCommandBuffer& cmd, VkCullModeFlags cullMode)
+    {
+        if (Update(m_Extended.cullMode, cullMode))
+            vkCmdSetCullMode(cmd, cullMode);
+    }
+
+    void VulkanDynamicState::SetFrontFace(const VkCommandBuffer& cmd, VkFrontFace frontFace)
+    {
+        if (Update(m_Extended.frontFace, frontFace))
+            vkCmdSetFrontFace(cmd, frontFace);
+    }
+
+    void VulkanDynamicState::SetPrimitiveTopology(const VkCommandBuffer& cmd, VkPrimitiveTopology topology)
+    {
+        if (Update(m_Extended.topology, topology))
+            vkCmdSetPrimitiveTopology(cmd, topology);
+    }
+
+    void VulkanDynamicState::SetPrimitiveRestartEnable(const VkCommandBuffer& cmd, bool enable)
+    {
+        if (Update(m_Extended.primitiveRestart, enable))
+            vkCmdSetPrimitiveRestartEnable(cmd, static_cast<VkBool32>(enable));
+    }
+
+    void VulkanDynamicState::SetDepthTestEnable(const VkCommandBuffer& cmd, bool enable)
+    {
+        if (Update(m_Extended.depthTest, enable))
+            vkCmdSetDepthTestEnable(cmd, static_cast<VkBool32>(enable));
+    }
+
+    void VulkanDynamicState::SetDepthWriteEnable(const VkCommandBuffer& cmd, bool enable)
+    {
+        if (Update(m_Extended.depthWrite, enable))
+            vkCmdSetDepthWriteEnable(cmd, static_cast<VkBool32>(enable));
+    }
+
+    void VulkanDynamicState::SetDepthCompareOp(const VkCommandBuffer& cmd, VkCompareOp compareOp)
+    {
+        if (Update(m_Extended.depthCompareOp, compareOp))
+            vkCmdSetDepthCompareOp(cmd, compareOp);
+    }
+
+    void VulkanDynamicState::SetPolygonMode(const VkCommandBuffer& cmd, VkPolygonMode polygonMode)
+    {
+        if (Update(m_Extended.polygonMode, polygonMode))
+            vkCmdSetPolygonModeEXT(cmd, polygonMode);
+    }
+
+    void VulkanDynamicState::SetColorBlend(const VkCommandBuffer& cmd, std::span<const VkPipelineColorBlendAttachmentState> attachments)
+    {
+        if (attachments.empty() || !Update(m_Extended.colorBlend, attachments))
+            return;
+
+        std::vector<VkBool32> enables;
+        std::vector<VkColorBlendEquationEXT> equations;
+        std::vector<VkColorComponentFlags> writeMasks;
+        enables.reserve(attachments.size());
+        equations.reserve(attachments.size());
+        writeMasks.reserve(attachments.size());
+
+        for (const auto& attachment : attachments) {
+            enables.push_back(attachment.blendEnable);
+            equations.push_back(VkColorBlendEquationEXT {
+                .srcColorBlendFactor = attachment.srcColorBlendFactor,
+                .dstColorBlendFactor = attachment.dstColorBlendFactor,
+                .colorBlendOp = attachment.colorBlendOp,
+                .srcAlphaBlendFactor = attachment.srcAlphaBlendFactor,
+                .dstAlphaBlendFactor = attachment.dstAlphaBlendFactor,
+                .alphaBlendOp = attachment.alphaBlendOp
+            });
+            writeMasks.push_back(attachment.colorWriteMask);
+        }
+
+        u32 count = static_cast<u32>(attachments.size());
+        vkCmdSetColorBlendEnableEXT(cmd, 0, count, enables.data());
+        vkCmdSetColorBlendEquationEXT(cmd, 0, count, equations.data());
+        vkCmdSetColorWriteMaskEXT(cmd, 0, count, writeMasks.data());
+    }
+
+    template <typename T, typename U>
+    bool VulkanDynamicState::Update(std::optional<T>& cached, const U& value)
+    {
+        if (cached.has_value() && Equal(*cached, value)) {
+            ++m_Stats.skipped;
+            return false;
+        }
+
+        cached = Store(value);
+        ++m_Stats.issued;
+        return true;
+    }
+
+}
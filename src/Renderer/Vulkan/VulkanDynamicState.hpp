@@ -0,0 +1,78 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "VulkanTypes.hpp"
+#include "VulkanContext.hpp"
+#include "VulkanGraphicsPipeline.hpp"
+
+namespace Renderer {
+
+    class VulkanDynamicState
+    {
+    public:
+        struct Stats
+        {
+            u32 issued { 0 };
+            u32 skipped { 0 };
+        };
+
+    public:
+        VulkanDynamicState(const Ref<VulkanContext>& context);
+
+        void Reset();
+
+        void BindPipeline(const VkCommandBuffer& cmd, const VulkanGraphicsPipeline& pipeline);
+        void Apply(const VkCommandBuffer& cmd, const VulkanGraphicsPipeline::Config& cfg);
+
+        void SetViewport(const VkCommandBuffer& cmd, const VkViewport& viewport);
+        void SetScissor(const VkCommandBuffer& cmd, const VkRect2D& scissor);
+
+        void SetCullMode(const VkCommandBuffer& cmd, VkCullModeFlags cullMode);
+        void SetFrontFace(const VkCommandBuffer& cmd, VkFrontFace frontFace);
+        void SetPrimitiveTopology(const VkCommandBuffer& cmd, VkPrimitiveTopology topology);
+        void SetPrimitiveRestartEnable(const VkCommandBuffer& cmd, bool enable);
+        void SetDepthTestEnable(const VkCommandBuffer& cmd, bool enable);
+        void SetDepthWriteEnable(const VkCommandBuffer& cmd, bool enable);
+        void SetDepthCompareOp(const VkCommandBuffer& cmd, VkCompareOp compareOp);
+
+        void SetPolygonMode(const VkCommandBuffer& cmd, VkPolygonMode polygonMode);
+        void SetColorBlend(const VkCommandBuffer& cmd, std::span<const VkPipelineColorBlendAttachmentState> attachments);
+
+        inline const Stats& GetStats() const { return m_Stats; }
+
+    private:
+        struct ExtendedState
+        {
+            std::optional<VkCullModeFlags> cullMode;
+            std::optional<VkFrontFace> frontFace;
+            std::optional<VkPrimitiveTopology> topology;
+            std::optional<bool> primitiveRestart;
+            std::optional<bool> depthTest;
+            std::optional<bool> depthWrite;
+            std::optional<VkCompareOp> depthCompareOp;
+            std::optional<VkPolygonMode> polygonMode;
+            std::optional<std::vector<VkPipelineColorBlendAttachmentState>> colorBlend;
+        };
+
+    private:
+        template <typename T, typename U>
+        bool Update(std::optional<T>& cached, const U& value);
+
+    private:
+        Ref<VulkanContext> m_Context;
+
+        VkPipeline m_BoundPipeline { VK_NULL_HANDLE };
+        const VulkanGraphicsPipeline* m_BoundShaderPipeline { nullptr };
+        bool m_BoundDynamic { false };
+
+        std::optional<VkViewport> m_Viewport;
+        std::optional<VkRect2D> m_Scissor;
+        ExtendedState m_Extended;
+
+        Stats m_Stats;
+    };
+
+}
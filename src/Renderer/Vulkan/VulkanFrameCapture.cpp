@@ -0,0 +1,304 @@
+#include "VulkanFrameCapture.hpp"
+
+#include <filesystem>
+
+#include "Core/ImageWriter.hpp"
+#include "Core/Profiler.hpp"
+
+namespace Renderer {
+
+    VulkanFrameCapture::VulkanFrameCapture(const Ref<VulkanContext>& context, const Config& config)
+        : m_Context(context), m_Config(config)
+    {
+        for (u32 i = 0; i < m_Config.ringSize; ++i)
+            m_Slots.push_back(CreateScope<Slot>());
+
+        m_IoThread = std::thread(&VulkanFrameCapture::IoThreadLoop, this);
+    }
+
+    VulkanFrameCapture::~VulkanFrameCapture()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_IoMutex);
+            m_IoStop = true;
+        }
+        m_IoCondition.notify_one();
+
+        if (m_IoThread.joinable())
+            m_IoThread.join();
+
+        for (auto& slot : m_Slots)
+            DestroySlot(*slot);
+    }
+
+    void VulkanFrameCapture::Start(const Request& request)
+    {
+        m_Request = request;
+        m_RemainingFrames = request.frameCount;
+        m_NextIndex = 0;
+
+        std::error_code error;
+        std::filesystem::create_directories(m_Request.outputDirectory, error);
+        if (error) {
+            LOG_ERROR("Failed to create capture directory {}: {}", m_Request.outputDirectory, error.message())
+            m_RemainingFrames = 0;
+            return;
+        }
+
+        LOG_INFO("Capturing {} frames to {}", m_RemainingFrames, m_Request.outputDirectory)
+    }
+
+    void VulkanFrameCapture::Collect()
+    {
+        PROFILE_SCOPE("VulkanFrameCapture::Collect")
+
+        usize queued = 0;
+
+        for (auto& slot : m_Slots) {
+            if (slot->state.load(std::memory_order_acquire) != SlotState::InFlight)
+                continue;
+
+            // The frame fence is recycled, but a later signal on the same queue
+            // still implies this copy has finished, so never wait here.
+            if (vkGetFenceStatus(m_Context->GetDevice(), slot->fence) != VK_SUCCESS)
+                continue;
+
+            if (!slot->coherent) {
+                VkMappedMemoryRange range {
+                    .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+                    .pNext = nullptr,
+                    .memory = slot->memory,
+                    .offset = 0,
+                    .size = VK_WHOLE_SIZE
+                };
+                VK_CHECK(vkInvalidateMappedMemoryRanges(m_Context->GetDevice(), 1, &range));
+            }
+
+            slot->state.store(SlotState::Writing, std::memory_order_release);
+
+            std::lock_guard<std::mutex> lock(m_IoMutex);
+            m_IoQueue.push_back(slot.get());
+            queued++;
+        }
+
+        if (queued != 0)
+            m_IoCondition.notify_one();
+    }
+
+    bool VulkanFrameCapture::RecordCopy(const VkCommandBuffer& cmd, VkImage image, VkExtent2D extent, VkFormat format, VkFence frameFence)
+    {
+        if (!IsCapturing())
+            return false;
+
+        if (!IsFormatSupported(format)) {
+            LOG_ERROR("Frame capture does not support format {}", static_cast<i32>(format))
+            m_RemainingFrames = 0;
+            return false;
+        }
+
+        Slot* slot = nullptr;
+        for (auto& candidate : m_Slots) {
+            if (candidate->state.load(std::memory_order_acquire) == SlotState::Free) {
+                slot = candidate.get();
+                break;
+            }
+        }
+
+        if (slot == nullptr) {
+            m_DroppedFrames++;
+            LOG_WARN("No free readback buffer, dropping capture frame ({} dropped)", m_DroppedFrames)
+            return false;
+        }
+
+        EnsureSlotCapacity(*slot, static_cast<VkDeviceSize>(extent.width) * extent.height * 4);
+
+        // Everything the IO thread needs is copied into the slot, so a new
+        // capture can start while earlier frames are still being written.
+        const char* extension = m_Request.fileFormat == FileFormat::Png ? "png" : "rgba";
+        slot->index = m_NextIndex++;
+        slot->extent = extent;
+        slot->format = format;
+        slot->fileFormat = m_Request.fileFormat;
+        slot->fence = frameFence;
+        slot->filepath = fmt::format("{}/frame_{:06}_{}x{}.{}", m_Request.outputDirectory, slot->index, extent.width, extent.height, extension);
+
+        VkBufferImageCopy region {
+            .bufferOffset = 0,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = 0,
+                .baseArrayLayer = 0,
+                .layerCount = 1
+            },
+            .imageOffset = { 0, 0, 0 },
+            .imageExtent = { extent.width, extent.height, 1 }
+        };
+
+        vkCmdCopyImageToBuffer(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot->buffer, 1, &region);
+
+        VkMemoryBarrier hostBarrier {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .pNext = nullptr,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_HOST_READ_BIT
+        };
+
+        vkCmdPipelineBarrier(
+            cmd,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+            0,
+            1, &hostBarrier,
+            0, nullptr,
+            0, nullptr
+        );
+
+        slot->state.store(SlotState::InFlight, std::memory_order_release);
+        m_RemainingFrames--;
+
+        return true;
+    }
+
+    void VulkanFrameCapture::Flush()
+    {
+        Collect();
+
+        std::unique_lock<std::mutex> lock(m_IoMutex);
+        m_IoIdleCondition.wait(lock, [this]{
+            return m_IoQueue.empty() && m_IoBusy == 0;
+        });
+    }
+
+    bool VulkanFrameCapture::IsFormatSupported(VkFormat format)
+    {
+        switch (format) {
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+            case VK_FORMAT_B8G8R8A8_UNORM:
+            case VK_FORMAT_B8G8R8A8_SRGB:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void VulkanFrameCapture::EnsureSlotCapacity(Slot& slot, VkDeviceSize size)
+    {
+        if (slot.buffer != VK_NULL_HANDLE && slot.size >= size)
+            return;
+
+        DestroySlot(slot);
+
+        VkBufferCreateInfo bufferInfo {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .size = size,
+            .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .queueFamilyIndexCount = 0,
+            .pQueueFamilyIndices = nullptr
+        };
+
+        VK_CHECK(vkCreateBuffer(m_Context->GetDevice(), &bufferInfo, nullptr, &slot.buffer));
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(m_Context->GetDevice(), slot.buffer, &requirements);
+
+        // Cached memory makes the CPU-side read fast; fall back to coherent
+        // uncached memory where the device offers nothing else.
+        auto memoryType = m_Context->FindMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+        if (!memoryType.has_value())
+            memoryType = m_Context->FindMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        VkMemoryAllocateInfo allocInfo {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .pNext = nullptr,
+            .allocationSize = requirements.size,
+            .memoryTypeIndex = memoryType.value()
+        };
+
+        VK_CHECK(vkAllocateMemory(m_Context->GetDevice(), &allocInfo, nullptr, &slot.memory));
+        VK_CHECK(vkBindBufferMemory(m_Context->GetDevice(), slot.buffer, slot.memory, 0));
+
+        void* mapped = nullptr;
+        VK_CHECK(vkMapMemory(m_Context->GetDevice(), slot.memory, 0, VK_WHOLE_SIZE, 0, &mapped));
+
+        slot.mapped = static_cast<u8*>(mapped);
+        slot.size = size;
+        slot.coherent = m_Context->GetMemoryProperties().memoryTypes[memoryType.value()].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    }
+
+    void VulkanFrameCapture::DestroySlot(Slot& slot)
+    {
+        if (slot.memory != VK_NULL_HANDLE) {
+            vkUnmapMemory(m_Context->GetDevice(), slot.memory);
+            vkFreeMemory(m_Context->GetDevice(), slot.memory, nullptr);
+        }
+
+        if (slot.buffer != VK_NULL_HANDLE)
+            vkDestroyBuffer(m_Context->GetDevice(), slot.buffer, nullptr);
+
+        slot.buffer = VK_NULL_HANDLE;
+        slot.memory = VK_NULL_HANDLE;
+        slot.mapped = nullptr;
+        slot.size = 0;
+    }
+
+    void VulkanFrameCapture::IoThreadLoop()
+    {
+        PROFILE_THREAD("Capture IO")
+
+        while (true) {
+            Slot* slot = nullptr;
+
+            {
+                std::unique_lock<std::mutex> lock(m_IoMutex);
+                m_IoCondition.wait(lock, [this]{
+                    return !m_IoQueue.empty() || m_IoStop;
+                });
+
+                if (m_IoQueue.empty())
+                    break;
+
+                slot = m_IoQueue.front();
+                m_IoQueue.pop_front();
+                m_IoBusy++;
+            }
+
+            WriteSlot(*slot);
+            slot->state.store(SlotState::Free, std::memory_order_release);
+
+            {
+                std::lock_guard<std::mutex> lock(m_IoMutex);
+                m_IoBusy--;
+            }
+            m_IoIdleCondition.notify_all();
+        }
+    }
+
+    void VulkanFrameCapture::WriteSlot(Slot& slot)
+    {
+        PROFILE_SCOPE("VulkanFrameCapture::WriteSlot")
+
+        usize size = static_cast<usize>(slot.extent.width) * slot.extent.height * 4;
+        const u8* pixels = slot.mapped;
+
+        std::vector<u8> swizzled;
+        if (slot.format == VK_FORMAT_B8G8R8A8_UNORM || slot.format == VK_FORMAT_B8G8R8A8_SRGB) {
+            swizzled.assign(slot.mapped, slot.mapped + size);
+            for (usize i = 0; i < size; i += 4)
+                std::swap(swizzled[i], swizzled[i + 2]);
+            pixels = swizzled.data();
+        }
+
+        bool written = slot.fileFormat == FileFormat::Png
+            ? ImageWriter::WritePng(slot.filepath, slot.extent.width, slot.extent.height, pixels)
+            : ImageWriter::WriteRaw(slot.filepath, pixels, size);
+
+        if (written)
+            m_WrittenFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+
+}
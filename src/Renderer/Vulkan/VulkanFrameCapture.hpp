@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "VulkanTypes.hpp"
+#include "VulkanContext.hpp"
+
+namespace Renderer {
+
+    class VulkanFrameCapture
+    {
+    public:
+        enum class FileFormat
+        {
+            Png,
+            Raw
+        };
+
+        struct Config
+        {
+            u32 ringSize { 4 };
+        };
+
+        struct Request
+        {
+            u32 frameCount { 0 };
+            std::string outputDirectory { "captures" };
+            FileFormat fileFormat { FileFormat::Png };
+        };
+
+    public:
+        VulkanFrameCapture(const Ref<VulkanContext>& context, const Config& config);
+        ~VulkanFrameCapture();
+
+        void Start(const Request& request);
+        inline bool IsCapturing() const { return m_RemainingFrames != 0; }
+
+        void Collect();
+        bool RecordCopy(const VkCommandBuffer& cmd, VkImage image, VkExtent2D extent, VkFormat format, VkFence frameFence);
+
+        void Flush();
+
+        inline u64 GetWrittenFrameCount() const { return m_WrittenFrames.load(std::memory_order_relaxed); }
+        inline u64 GetDroppedFrameCount() const { return m_DroppedFrames; }
+
+        static bool IsFormatSupported(VkFormat format);
+
+    private:
+        enum class SlotState : u8
+        {
+            Free,
+            InFlight,
+            Writing
+        };
+
+        struct Slot
+        {
+            VkBuffer buffer { VK_NULL_HANDLE };
+            VkDeviceMemory memory { VK_NULL_HANDLE };
+            VkDeviceSize size { 0 };
+            u8* mapped { nullptr };
+            bool coherent { false };
+
+            std::atomic<SlotState> state { SlotState::Free };
+            VkFence fence { VK_NULL_HANDLE };
+
+            u64 index { 0 };
+            VkExtent2D extent { 0, 0 };
+            VkFormat format { VK_FORMAT_UNDEFINED };
+            FileFormat fileFormat { FileFormat::Png };
+            std::string filepath;
+        };
+
+    private:
+        void EnsureSlotCapacity(Slot& slot, VkDeviceSize size);
+        void DestroySlot(Slot& slot);
+
+        void IoThreadLoop();
+        void WriteSlot(Slot& slot);
+
+    private:
+        Ref<VulkanContext> m_Context;
+        Config m_Config;
+
+        std::vector<Scope<Slot>> m_Slots;
+
+        Request m_Request;
+        u32 m_RemainingFrames { 0 };
+        u64 m_NextIndex { 0 };
+        u64 m_DroppedFrames { 0 };
+        std::atomic<u64> m_WrittenFrames { 0 };
+
+        std::thread m_IoThread;
+        std::mutex m_IoMutex;
+        std::condition_variable m_IoCondition;
+        std::condition_variable m_IoIdleCondition;
+        std::deque<Slot*> m_IoQueue;
+        usize m_IoBusy { 0 };
+        bool m_IoStop { false };
+    };
+
+}
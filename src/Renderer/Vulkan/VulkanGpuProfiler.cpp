@@ -0,0 +1,247 @@
+#include "VulkanGpuProfiler.hpp"
+
+#include <algorithm>
+
+#include <spdlog/fmt/fmt.h>
+
+namespace Renderer {
+
+    VulkanGpuProfiler::VulkanGpuProfiler(const Ref<VulkanContext>& context, const Config& config)
+        : m_Context(context), m_Config(config)
+    {
+        u32 familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_Context->GetPhysicalDevice(), &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_Context->GetPhysicalDevice(), &familyCount, families.data());
+
+        u32 validBits = families.at(m_Context->GetGraphicsQueueIndex()).timestampValidBits;
+        if (validBits == 0) {
+            LOG_WARN("Graphics queue does not support timestamps, GPU profiling disabled")
+            return;
+        }
+
+        if (validBits < 64)
+            m_TimestampMask = (u64{1} << validBits) - 1;
+
+        m_TimestampPeriodNs = static_cast<f64>(m_Context->GetPhysicalDeviceProperties().limits.timestampPeriod);
+
+        VkQueryPoolCreateInfo poolInfo {
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = m_Config.maxScopesPerFrame * 2,
+            .pipelineStatistics = 0
+        };
+
+        m_Slots.resize(m_Config.framesInFlight);
+        for (auto& slot : m_Slots)
+            VK_CHECK(vkCreateQueryPool(m_Context->GetDevice(), &poolInfo, nullptr, &slot.pool));
+
+        m_Supported = true;
+    }
+
+    VulkanGpuProfiler::~VulkanGpuProfiler()
+    {
+        for (auto& slot : m_Slots) {
+            if (slot.pool != VK_NULL_HANDLE)
+                vkDestroyQueryPool(m_Context->GetDevice(), slot.pool, nullptr);
+        }
+    }
+
+    void VulkanGpuProfiler::BeginFrame(const VkCommandBuffer& cmd, usize frameIndex)
+    {
+        if (!m_Supported)
+            return;
+
+        // The slot is only reused after its fence has been waited on, so its
+        // queries from framesInFlight frames ago can be read without stalling.
+        m_CurrentSlot = &m_Slots.at(frameIndex % m_Slots.size());
+        CollectResults(*m_CurrentSlot);
+
+        m_CurrentSlot->scopeNames.clear();
+        vkCmdResetQueryPool(cmd, m_CurrentSlot->pool, 0, m_Config.maxScopesPerFrame * 2);
+
+        m_CurrentSlot->frameScope = BeginScope(cmd, s_FrameScopeName);
+        m_FrameCount++;
+
+        if (m_Config.logIntervalFrames != 0 && m_FrameCount % m_Config.logIntervalFrames == 0)
+            LogStats();
+    }
+
+    void VulkanGpuProfiler::EndFrame(const VkCommandBuffer& cmd)
+    {
+        if (!m_Supported || m_CurrentSlot == nullptr)
+            return;
+
+        EndScope(cmd, m_CurrentSlot->frameScope);
+        m_CurrentSlot = nullptr;
+    }
+
+    std::optional<f64> VulkanGpuProfiler::ResolveFrame(usize frameIndex)
+    {
+        if (!m_Supported)
+            return std::nullopt;
+
+        // Only valid once the frame's fence has signaled; the slot is then
+        // skipped when BeginFrame reuses it.
+        if (!CollectResults(m_Slots.at(frameIndex % m_Slots.size())))
+            return std::nullopt;
+
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        auto it = m_LastFrame.find(s_FrameScopeName);
+        if (it == m_LastFrame.end())
+            return std::nullopt;
+
+        return it->second;
+    }
+
+    u32 VulkanGpuProfiler::BeginScope(const VkCommandBuffer& cmd, const std::string& name)
+    {
+        if (!m_Supported || m_CurrentSlot == nullptr)
+            return s_InvalidScope;
+
+        if (m_CurrentSlot->scopeNames.size() >= m_Config.maxScopesPerFrame) {
+            LOG_WARN("GPU profiler scope limit ({}) reached, dropping scope {}", m_Config.maxScopesPerFrame, name)
+            return s_InvalidScope;
+        }
+
+        u32 scope = static_cast<u32>(m_CurrentSlot->scopeNames.size());
+        m_CurrentSlot->scopeNames.push_back(name);
+
+        vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, m_CurrentSlot->pool, scope * 2);
+
+        return scope;
+    }
+
+    void VulkanGpuProfiler::EndScope(const VkCommandBuffer& cmd, u32 scope)
+    {
+        if (!m_Supported || m_CurrentSlot == nullptr || scope == s_InvalidScope)
+            return;
+
+        vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, m_CurrentSlot->pool, scope * 2 + 1);
+    }
+
+    std::unordered_map<std::string, VulkanGpuProfiler::ScopeStats> VulkanGpuProfiler::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+
+        std::unordered_map<std::string, ScopeStats> stats;
+        for (const auto& [name, history] : m_History) {
+            if (history.samples.empty())
+                continue;
+
+            std::vector<f64> sorted = history.samples;
+            std::sort(sorted.begin(), sorted.end());
+
+            f64 sum = 0.0;
+            for (f64 sample : sorted)
+                sum += sample;
+
+            usize p99Index = std::min(sorted.size() - 1, (sorted.size() * 99) / 100);
+
+            stats[name] = ScopeStats {
+                .lastMs = history.lastMs,
+                .minMs = sorted.front(),
+                .avgMs = sum / static_cast<f64>(sorted.size()),
+                .p99Ms = sorted[p99Index],
+                .sampleCount = static_cast<u32>(sorted.size())
+            };
+        }
+
+        return stats;
+    }
+
+    std::unordered_map<std::string, f64> VulkanGpuProfiler::GetLastFrameTimings() const
+    {
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        return m_LastFrame;
+    }
+
+    void VulkanGpuProfiler::LogStats() const
+    {
+#ifndef NDEBUG
+        auto stats = GetStats();
+        if (stats.empty())
+            return;
+
+        LOG_INFO("{}", FormatStats(stats))
+#endif
+    }
+
+    std::string VulkanGpuProfiler::FormatStats(const std::unordered_map<std::string, ScopeStats>& stats)
+    {
+        if (stats.empty())
+            return {};
+
+        std::vector<std::pair<std::string, ScopeStats>> sorted(stats.begin(), stats.end());
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+            return a.second.avgMs > b.second.avgMs;
+        });
+
+        std::string result = fmt::format("GPU timings over last {} frames:", sorted.front().second.sampleCount);
+        for (const auto& [name, s] : sorted)
+            result += fmt::format("\n - {:<24} min {:.3f} ms  avg {:.3f} ms  p99 {:.3f} ms", name, s.minMs, s.avgMs, s.p99Ms);
+
+        return result;
+    }
+
+    bool VulkanGpuProfiler::CollectResults(FrameSlot& slot)
+    {
+        if (slot.scopeNames.empty())
+            return false;
+
+        u32 queryCount = static_cast<u32>(slot.scopeNames.size()) * 2;
+
+        // Each query is followed by its availability word.
+        std::vector<u64> results(queryCount * 2, 0);
+        VkResult result = vkGetQueryPoolResults(
+            m_Context->GetDevice(), slot.pool,
+            0, queryCount,
+            results.size() * sizeof(u64), results.data(), sizeof(u64) * 2,
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+        );
+
+        if (result != VK_SUCCESS && result != VK_NOT_READY)
+            return false;
+
+        std::unordered_map<std::string, f64> frameTimings;
+        for (u32 scope = 0; scope < slot.scopeNames.size(); ++scope) {
+            u64 begin = results[scope * 4 + 0];
+            u64 beginAvailable = results[scope * 4 + 1];
+            u64 end = results[scope * 4 + 2];
+            u64 endAvailable = results[scope * 4 + 3];
+
+            if (!beginAvailable || !endAvailable)
+                continue;
+
+            u64 ticks = ((end & m_TimestampMask) - (begin & m_TimestampMask)) & m_TimestampMask;
+            f64 ms = static_cast<f64>(ticks) * m_TimestampPeriodNs / 1'000'000.0;
+
+            frameTimings[slot.scopeNames[scope]] += ms;
+        }
+
+        slot.scopeNames.clear();
+
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        for (const auto& [name, ms] : frameTimings)
+            AddSample(name, ms);
+        m_LastFrame = std::move(frameTimings);
+
+        return true;
+    }
+
+    void VulkanGpuProfiler::AddSample(const std::string& name, f64 ms)
+    {
+        History& history = m_History[name];
+        history.lastMs = ms;
+
+        if (history.samples.size() < m_Config.historySize) {
+            history.samples.push_back(ms);
+        } else {
+            history.samples[history.next] = ms;
+            history.next = (history.next + 1) % history.samples.size();
+        }
+    }
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "VulkanTypes.hpp"
+#include "VulkanContext.hpp"
+
+namespace Renderer {
+
+    class VulkanGpuProfiler
+    {
+    public:
+        struct Config
+        {
+            u32 framesInFlight { 2 };
+            u32 maxScopesPerFrame { 128 };
+            u32 historySize { 240 };
+            u32 logIntervalFrames { 0 };
+        };
+
+        struct ScopeStats
+        {
+            f64 lastMs { 0.0 };
+            f64 minMs { 0.0 };
+            f64 avgMs { 0.0 };
+            f64 p99Ms { 0.0 };
+            u32 sampleCount { 0 };
+        };
+
+        inline static constexpr u32 s_InvalidScope { std::numeric_limits<u32>::max() };
+        inline static const std::string s_FrameScopeName { "Frame" };
+
+    public:
+        VulkanGpuProfiler(const Ref<VulkanContext>& context, const Config& config);
+        ~VulkanGpuProfiler();
+
+        inline bool IsSupported() const { return m_Supported; }
+
+        void BeginFrame(const VkCommandBuffer& cmd, usize frameIndex);
+        void EndFrame(const VkCommandBuffer& cmd);
+        std::optional<f64> ResolveFrame(usize frameIndex);
+
+        u32 BeginScope(const VkCommandBuffer& cmd, const std::string& name);
+        void EndScope(const VkCommandBuffer& cmd, u32 scope);
+
+        std::unordered_map<std::string, ScopeStats> GetStats() const;
+        std::unordered_map<std::string, f64> GetLastFrameTimings() const;
+        void LogStats() const;
+
+        static std::string FormatStats(const std::unordered_map<std::string, ScopeStats>& stats);
+
+    private:
+        struct FrameSlot
+        {
+            VkQueryPool pool { VK_NULL_HANDLE };
+            std::vector<std::string> scopeNames;
+            u32 frameScope { s_InvalidScope };
+        };
+
+        struct History
+        {
+            std::vector<f64> samples;
+            usize next { 0 };
+            f64 lastMs { 0.0 };
+        };
+
+    private:
+        bool CollectResults(FrameSlot& slot);
+        void AddSample(const std::string& name, f64 ms);
+
+    private:
+        Ref<VulkanContext> m_Context;
+        Config m_Config;
+
+        bool m_Supported { false };
+        f64 m_TimestampPeriodNs { 1.0 };
+        u64 m_TimestampMask { std::numeric_limits<u64>::max() };
+
+        std::vector<FrameSlot> m_Slots;
+        FrameSlot* m_CurrentSlot { nullptr };
+        u64 m_FrameCount { 0 };
+
+        mutable std::mutex m_StatsMutex;
+        std::unordered_map<std::string, History> m_History;
+        std::unordered_map<std::string, f64> m_LastFrame;
+    };
+
+}
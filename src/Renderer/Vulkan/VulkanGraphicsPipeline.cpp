@@ -1,9 +1,11 @@
 #include "VulkanGraphicsPipeline.hpp"
 
+#include <array>
+
 namespace Renderer {
 
-    VulkanGraphicsPipeline::VulkanGraphicsPipeline(const Ref<VulkanContext>& context, const Config& cfg)
-        : m_Context(context)
+    VulkanGraphicsPipeline::VulkanGraphicsPipeline(const Ref<VulkanContext>& context, const Config& cfg, VkPipelineCache pipelineCache)
+        : m_Context(context), m_DynamicState(cfg.dynamicState)
     {
         VkPipelineLayoutCreateInfo layoutInfo {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
@@ -17,28 +19,256 @@ namespace Renderer {
 
         VK_CHECK(vkCreatePipelineLayout(m_Context->GetDevice(), &layoutInfo, nullptr, &m_Layout));
 
-        std::vector<VkPipelineShaderStageCreateInfo> shaderStages;;
+        ShaderReflection reflection = Reflect(cfg);
+        if (UsesShaderObjects(m_Context, cfg)) {
+            InitShaderObjects(cfg, reflection, CreateRef<VulkanShaderObjects>(m_Context, cfg.shaders, cfg.specialization, cfg.descriptorSetLayouts, cfg.pushConstantRanges));
+            return;
+        }
+
+        m_Pipeline = CreatePipeline(m_Context, cfg, reflection, m_Layout, 0, pipelineCache);
+    }
+
+    VulkanGraphicsPipeline::VulkanGraphicsPipeline(const Ref<VulkanContext>& context, const Config& cfg, VulkanLayoutCache& layoutCache, VkPipelineCache pipelineCache)
+        : m_Context(context), m_OwnsLayout(false), m_DynamicState(cfg.dynamicState)
+    {
+        ShaderReflection reflection = Reflect(cfg);
+        m_Layout = ResolveLayout(cfg, reflection, layoutCache);
+
+        if (UsesShaderObjects(m_Context, cfg)) {
+            InitShaderObjects(cfg, reflection, CreateShaderObjects(m_Context, cfg, reflection, layoutCache));
+            return;
+        }
+
+        m_Pipeline = CreatePipeline(m_Context, cfg, reflection, m_Layout, 0, pipelineCache);
+    }
+
+    VulkanGraphicsPipeline::VulkanGraphicsPipeline(const Ref<VulkanContext>& context, const Config& cfg, VkPipelineLayout layout, std::span<const VkPipeline> libraries, bool optimize, VkPipelineCache pipelineCache)
+        : m_Context(context), m_Layout(layout), m_OwnsLayout(false), m_DynamicState(cfg.dynamicState)
+    {
+        VkPipelineLibraryCreateInfoKHR libraryInfo {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR,
+            .pNext = nullptr,
+            .libraryCount = static_cast<u32>(libraries.size()),
+            .pLibraries = libraries.data()
+        };
+
+        // Without link time optimization this only stitches the libraries
+        // together, which is cheap enough to do at draw time.
+        VkGraphicsPipelineCreateInfo createInfo {
+            .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+            .pNext = &libraryInfo,
+            .flags = optimize ? VkPipelineCreateFlags(VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT) : 0,
+            .stageCount = 0,
+            .pStages = nullptr,
+            .pVertexInputState = nullptr,
+            .pInputAssemblyState = nullptr,
+            .pTessellationState = nullptr,
+            .pViewportState = nullptr,
+            .pRasterizationState = nullptr,
+            .pMultisampleState = nullptr,
+            .pDepthStencilState = nullptr,
+            .pColorBlendState = nullptr,
+            .pDynamicState = nullptr,
+            .layout = m_Layout,
+            .renderPass = VK_NULL_HANDLE,
+            .subpass = 0,
+            .basePipelineHandle = VK_NULL_HANDLE,
+            .basePipelineIndex = -1
+        };
+
+        VK_CHECK(vkCreateGraphicsPipelines(m_Context->GetDevice(), pipelineCache, 1, &createInfo, nullptr, &m_Pipeline));
+    }
+
+    VulkanGraphicsPipeline::VulkanGraphicsPipeline(const Ref<VulkanContext>& context, const Config& cfg, VkPipelineLayout layout, const Ref<VulkanShaderObjects>& shaderObjects)
+        : m_Context(context), m_Layout(layout), m_OwnsLayout(false)
+    {
+        InitShaderObjects(cfg, Reflect(cfg), shaderObjects);
+    }
+
+    VulkanGraphicsPipeline::~VulkanGraphicsPipeline()
+    {
+        if (m_Pipeline != VK_NULL_HANDLE)
+            vkDestroyPipeline(m_Context->GetDevice(), m_Pipeline, nullptr);
+
+        if (m_OwnsLayout && m_Layout != VK_NULL_HANDLE)
+            vkDestroyPipelineLayout(m_Context->GetDevice(), m_Layout, nullptr);
+    }
+
+    bool VulkanGraphicsPipeline::IsValid() const
+    {
+        if (m_ShaderObjects)
+            return m_ShaderObjects->IsValid();
+
+        return m_Pipeline != VK_NULL_HANDLE;
+    }
+
+    ShaderReflection VulkanGraphicsPipeline::Reflect(const Config& cfg)
+    {
+        ShaderReflection reflection;
+        for (const auto& shader : cfg.shaders)
+            reflection.Merge(shader->GetReflection());
+        return reflection;
+    }
+
+    VkPipelineLayout VulkanGraphicsPipeline::ResolveLayout(const Config& cfg, const ShaderReflection& reflection, VulkanLayoutCache& layoutCache)
+    {
+        // Layouts come from the cache, so pipelines with matching interfaces
+        // share one layout and bound descriptor sets stay compatible.
+        if (cfg.descriptorSetLayouts.empty() && cfg.pushConstantRanges.empty())
+            return layoutCache.GetPipelineLayout(reflection);
+
+        return layoutCache.GetPipelineLayout(cfg.descriptorSetLayouts, cfg.pushConstantRanges);
+    }
+
+    std::vector<VkDynamicState> VulkanGraphicsPipeline::GetDynamicStates(const Ref<VulkanContext>& context, const Config& cfg)
+    {
+        std::vector<VkDynamicState> dynamicStates {
+            VK_DYNAMIC_STATE_VIEWPORT,
+            VK_DYNAMIC_STATE_SCISSOR
+        };
+
+        if (!cfg.dynamicState)
+            return dynamicStates;
+
+        // extended_dynamic_state and extended_dynamic_state2 are core in 1.3.
+        dynamicStates.insert(dynamicStates.end(), {
+            VK_DYNAMIC_STATE_CULL_MODE,
+            VK_DYNAMIC_STATE_FRONT_FACE,
+            VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY,
+            VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE,
+            VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE,
+            VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE,
+            VK_DYNAMIC_STATE_DEPTH_COMPARE_OP
+        });
+
+        if (context->SupportsExtendedDynamicState3()) {
+            dynamicStates.insert(dynamicStates.end(), {
+                VK_DYNAMIC_STATE_POLYGON_MODE_EXT,
+                VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT,
+                VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT,
+                VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT
+            });
+        }
+
+        return dynamicStates;
+    }
+
+    void VulkanGraphicsPipeline::GetVertexInput(
+        const Config& cfg,
+        const ShaderReflection& reflection,
+        std::vector<VkVertexInputBindingDescription>& bindings,
+        std::vector<VkVertexInputAttributeDescription>& attributes
+    )
+    {
+        bindings = cfg.vertexBindingDescriptions;
+        attributes = cfg.vertexAttributeDescriptions;
+
+        // Without an explicit vertex layout, the reflected inputs are packed
+        // in location order into a single interleaved binding.
+        if (bindings.empty() && attributes.empty() && !reflection.vertexInputs.empty()) {
+            u32 offset = 0;
+            for (const auto& input : reflection.vertexInputs) {
+                attributes.push_back(VkVertexInputAttributeDescription {
+                    .location = input.location,
+                    .binding = 0,
+                    .format = input.format,
+                    .offset = offset
+                });
+                offset += input.size;
+            }
+
+            bindings.push_back(VkVertexInputBindingDescription {
+                .binding = 0,
+                .stride = offset,
+                .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+            });
+        }
+    }
+
+    bool VulkanGraphicsPipeline::UsesShaderObjects(const Ref<VulkanContext>& context, const Config& cfg)
+    {
+        return cfg.shaderObjects && context->SupportsShaderObject();
+    }
+
+    Ref<VulkanShaderObjects> VulkanGraphicsPipeline::CreateShaderObjects(
+        const Ref<VulkanContext>& context,
+        const Config& cfg,
+        const ShaderReflection& reflection,
+        VulkanLayoutCache& layoutCache
+    )
+    {
+        // Shader objects take the layout's interface rather than the layout,
+        // resolved the same way so descriptor sets bound through it match.
+        if (cfg.descriptorSetLayouts.empty() && cfg.pushConstantRanges.empty()) {
+            std::vector<VkDescriptorSetLayout> setLayouts = layoutCache.GetDescriptorSetLayouts(reflection);
+
+            std::vector<VkPushConstantRange> pushConstantRanges;
+            if (reflection.pushConstants.has_value())
+                pushConstantRanges.push_back(reflection.pushConstants.value());
+
+            return CreateRef<VulkanShaderObjects>(context, cfg.shaders, cfg.specialization, setLayouts, pushConstantRanges);
+        }
+
+        return CreateRef<VulkanShaderObjects>(context, cfg.shaders, cfg.specialization, cfg.descriptorSetLayouts, cfg.pushConstantRanges);
+    }
+
+    VkPipeline VulkanGraphicsPipeline::CreatePipeline(
+        const Ref<VulkanContext>& context,
+        const Config& cfg,
+        const ShaderReflection& reflection,
+        VkPipelineLayout layout,
+        VkGraphicsPipelineLibraryFlagsEXT parts,
+        VkPipelineCache pipelineCache
+    )
+    {
+        // A zero part mask creates a complete pipeline; otherwise only the
+        // state belonging to the requested library parts is provided.
+        auto includes = [parts](VkGraphicsPipelineLibraryFlagsEXT part) {
+            return parts == 0 || (parts & part) != 0;
+        };
+
+        bool vertexInput = includes(VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT);
+        bool preRasterization = includes(VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT);
+        bool fragmentShader = includes(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT);
+        bool fragmentOutput = includes(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT);
+
+        std::vector<VkSpecializationInfo> specializationInfos;
+        specializationInfos.reserve(cfg.shaders.size());
+
+        std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
         shaderStages.reserve(cfg.shaders.size());
         for (const auto& shader : cfg.shaders) {
+            bool fragment = shader->GetStage() == VK_SHADER_STAGE_FRAGMENT_BIT;
+            if (fragment ? !fragmentShader : !preRasterization)
+                continue;
+
+            const VkSpecializationInfo* specializationInfo = nullptr;
+            if (auto it = cfg.specialization.find(shader->GetStage()); it != cfg.specialization.end() && !it->second.IsEmpty())
+                specializationInfo = &specializationInfos.emplace_back(it->second.GetInfo());
+
             shaderStages.push_back(VkPipelineShaderStageCreateInfo {
                 .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
                 .pNext = nullptr,
                 .flags = 0,
                 .stage = shader->GetStage(),
                 .module = shader->GetModule(),
-                .pName = "main",
-                .pSpecializationInfo = nullptr
+                .pName = shader->GetReflection().entryPoint.c_str(),
+                .pSpecializationInfo = specializationInfo
             });
         }
 
+        std::vector<VkVertexInputBindingDescription> vertexBindings;
+        std::vector<VkVertexInputAttributeDescription> vertexAttributes;
+        GetVertexInput(cfg, reflection, vertexBindings, vertexAttributes);
+
         VkPipelineVertexInputStateCreateInfo vertexInputState {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
             .pNext = nullptr,
             .flags = 0,
-            .vertexBindingDescriptionCount = static_cast<u32>(cfg.vertexBindingDescriptions.size()),
-            .pVertexBindingDescriptions = cfg.vertexBindingDescriptions.data(),
-            .vertexAttributeDescriptionCount = static_cast<u32>(cfg.vertexAttributeDescriptions.size()),
-            .pVertexAttributeDescriptions = cfg.vertexAttributeDescriptions.data()
+            .vertexBindingDescriptionCount = static_cast<u32>(vertexBindings.size()),
+            .pVertexBindingDescriptions = vertexBindings.data(),
+            .vertexAttributeDescriptionCount = static_cast<u32>(vertexAttributes.size()),
+            .pVertexAttributeDescriptions = vertexAttributes.data()
         };
 
         VkPipelineInputAssemblyStateCreateInfo inputAssemblyState {
@@ -113,10 +343,7 @@ namespace Renderer {
             .blendConstants = { 0.0f, 0.0f, 0.0f, 0.0f }
         };
 
-        std::vector<VkDynamicState> dynamicStates {
-            VK_DYNAMIC_STATE_VIEWPORT,
-            VK_DYNAMIC_STATE_SCISSOR
-        };
+        std::vector<VkDynamicState> dynamicStates = GetDynamicStates(context, cfg);
 
         VkPipelineDynamicStateCreateInfo dynamicState {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
@@ -136,53 +363,118 @@ namespace Renderer {
             .stencilAttachmentFormat = cfg.stencilAttachmentFormat
         };
 
+        VkGraphicsPipelineLibraryCreateInfoEXT libraryInfo {
+            .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT,
+            .pNext = &renderingInfo,
+            .flags = parts
+        };
+
+        // Libraries retain what the optimizing link needs to recompile the
+        // parts as a whole.
         VkGraphicsPipelineCreateInfo createInfo {
             .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-            .pNext = &renderingInfo,
-            .flags = 0,
+            .pNext = parts != 0 ? static_cast<const void*>(&libraryInfo) : &renderingInfo,
+            .flags = parts != 0 ? VkPipelineCreateFlags(VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT) : 0,
             .stageCount = static_cast<u32>(shaderStages.size()),
-            .pStages = shaderStages.data(),
-            .pVertexInputState = &vertexInputState,
-            .pInputAssemblyState = &inputAssemblyState,
+            .pStages = shaderStages.empty() ? nullptr : shaderStages.data(),
+            .pVertexInputState = vertexInput ? &vertexInputState : nullptr,
+            .pInputAssemblyState = vertexInput ? &inputAssemblyState : nullptr,
             .pTessellationState = nullptr,
-            .pViewportState = &viewportState,
-            .pRasterizationState = &rasterizationState,
-            .pMultisampleState = &multisampleState,
-            .pDepthStencilState = &depthStencilState,
-            .pColorBlendState = &colorBlendState,
+            .pViewportState = preRasterization ? &viewportState : nullptr,
+            .pRasterizationState = preRasterization ? &rasterizationState : nullptr,
+            .pMultisampleState = fragmentShader || fragmentOutput ? &multisampleState : nullptr,
+            .pDepthStencilState = fragmentShader ? &depthStencilState : nullptr,
+            .pColorBlendState = fragmentOutput ? &colorBlendState : nullptr,
             .pDynamicState = &dynamicState,
-            .layout = m_Layout,
+            .layout = preRasterization || fragmentShader ? layout : VK_NULL_HANDLE,
             .renderPass = VK_NULL_HANDLE,
             .subpass = 0,
             .basePipelineHandle = VK_NULL_HANDLE,
             .basePipelineIndex = -1
         };
 
-        VK_CHECK(vkCreateGraphicsPipelines(m_Context->GetDevice(), VK_NULL_HANDLE, 1, &createInfo, nullptr, &m_Pipeline));
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VK_CHECK(vkCreateGraphicsPipelines(context->GetDevice(), pipelineCache, 1, &createInfo, nullptr, &pipeline));
+        return pipeline;
     }
 
-    VulkanGraphicsPipeline::~VulkanGraphicsPipeline()
+    void VulkanGraphicsPipeline::InitShaderObjects(const Config& cfg, const ShaderReflection& reflection, const Ref<VulkanShaderObjects>& shaderObjects)
     {
-        if (m_Pipeline != VK_NULL_HANDLE)
-            vkDestroyPipeline(m_Context->GetDevice(), m_Pipeline, nullptr);
+        m_ShaderObjects = shaderObjects;
+        m_DynamicState = true;
+        m_RasterSamples = cfg.rasterSamples;
+        m_LineWidth = cfg.lineWidth;
 
-        if (m_Layout != VK_NULL_HANDLE)
-            vkDestroyPipelineLayout(m_Context->GetDevice(), m_Layout, nullptr);
+        std::vector<VkVertexInputBindingDescription> bindings;
+        std::vector<VkVertexInputAttributeDescription> attributes;
+        GetVertexInput(cfg, reflection, bindings, attributes);
+
+        m_VertexBindings.reserve(bindings.size());
+        for (const auto& binding : bindings) {
+            m_VertexBindings.push_back(VkVertexInputBindingDescription2EXT {
+                .sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_BINDING_DESCRIPTION_2_EXT,
+                .pNext = nullptr,
+                .binding = binding.binding,
+                .stride = binding.stride,
+                .inputRate = binding.inputRate,
+                .divisor = 1
+            });
+        }
+
+        m_VertexAttributes.reserve(attributes.size());
+        for (const auto& attribute : attributes) {
+            m_VertexAttributes.push_back(VkVertexInputAttributeDescription2EXT {
+                .sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT,
+                .pNext = nullptr,
+                .location = attribute.location,
+                .binding = attribute.binding,
+                .format = attribute.format,
+                .offset = attribute.offset
+            });
+        }
     }
 
     void VulkanGraphicsPipeline::Bind(const VkCommandBuffer& cmd) const
     {
-        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
+        if (!m_ShaderObjects) {
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
+            return;
+        }
+
+        m_ShaderObjects->Bind(cmd);
+
+        // Nothing is baked with shader objects. The states a dynamic pipeline
+        // would still hold are set here; the rest is left to the caller as
+        // for any pipeline with dynamic state.
+        static constexpr std::array<VkSampleMask, 2> sampleMask { ~0u, ~0u };
+
+        vkCmdSetVertexInputEXT(cmd,
+            static_cast<u32>(m_VertexBindings.size()), m_VertexBindings.data(),
+            static_cast<u32>(m_VertexAttributes.size()), m_VertexAttributes.data());
+        vkCmdSetRasterizerDiscardEnable(cmd, VK_FALSE);
+        vkCmdSetLineWidth(cmd, m_LineWidth);
+        vkCmdSetDepthBiasEnable(cmd, VK_FALSE);
+        vkCmdSetDepthBoundsTestEnable(cmd, VK_FALSE);
+        vkCmdSetStencilTestEnable(cmd, VK_FALSE);
+        vkCmdSetRasterizationSamplesEXT(cmd, m_RasterSamples);
+        vkCmdSetSampleMaskEXT(cmd, m_RasterSamples, sampleMask.data());
+        vkCmdSetAlphaToCoverageEnableEXT(cmd, VK_FALSE);
     }
 
     void VulkanGraphicsPipeline::SetViewport(const VkCommandBuffer& cmd, const VkViewport& viewport)
     {
-        vkCmdSetViewport(cmd, 0, 1, &viewport);
+        if (m_ShaderObjects)
+            vkCmdSetViewportWithCount(cmd, 1, &viewport);
+        else
+            vkCmdSetViewport(cmd, 0, 1, &viewport);
     }
 
     void VulkanGraphicsPipeline::SetScissor(const VkCommandBuffer& cmd, const VkRect2D& scissor)
     {
-        vkCmdSetScissor(cmd, 0, 1, &scissor);
+        if (m_ShaderObjects)
+            vkCmdSetScissorWithCount(cmd, 1, &scissor);
+        else
+            vkCmdSetScissor(cmd, 0, 1, &scissor);
     }
 
 }
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <map>
+#include <span>
+
 #include "VulkanTypes.hpp"
 #include "VulkanContext.hpp"
 #include "VulkanShader.hpp"
+#include "VulkanLayoutCache.hpp"
+#include "VulkanShaderObjects.hpp"
+#include "VulkanSpecializationConstants.hpp"
 
 namespace Renderer {
 
@@ -12,6 +18,7 @@ namespace Renderer {
         struct Config
         {
             std::vector<Ref<VulkanShader>> shaders;
+            std::map<VkShaderStageFlagBits, VulkanSpecializationConstants> specialization;
 
             std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
             std::vector<VkPushConstantRange> pushConstantRanges;
@@ -37,24 +44,80 @@ namespace Renderer {
             std::vector<VkFormat> colorAttachmentFormats;
             VkFormat depthAttachmentFormat { VK_FORMAT_UNDEFINED };
             VkFormat stencilAttachmentFormat { VK_FORMAT_UNDEFINED };
+
+            // Leaves cull mode, front face, topology, depth and, with
+            // extended_dynamic_state3, polygon mode and blending to be set
+            // per draw, so configs differing only there share a pipeline.
+            bool dynamicState { false };
+
+            // Binds linked shader objects instead of a pipeline when the
+            // device supports them. Every state is then dynamic, so configs
+            // differing in any state share the compiled shaders.
+            bool shaderObjects { false };
         };
 
     public:
-        VulkanGraphicsPipeline(const Ref<VulkanContext>& context, const Config& cfg);
+        VulkanGraphicsPipeline(const Ref<VulkanContext>& context, const Config& cfg, VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+        VulkanGraphicsPipeline(const Ref<VulkanContext>& context, const Config& cfg, VulkanLayoutCache& layoutCache, VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+        VulkanGraphicsPipeline(const Ref<VulkanContext>& context, const Config& cfg, VkPipelineLayout layout, std::span<const VkPipeline> libraries, bool optimize, VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+        VulkanGraphicsPipeline(const Ref<VulkanContext>& context, const Config& cfg, VkPipelineLayout layout, const Ref<VulkanShaderObjects>& shaderObjects);
         ~VulkanGraphicsPipeline();
 
         inline const VkPipelineLayout& GetLayout() const { return m_Layout; }
         inline const VkPipeline& GetPipeline() const { return m_Pipeline; }
+        inline bool HasDynamicState() const { return m_DynamicState; }
+        inline bool UsesShaderObjects() const { return m_ShaderObjects != nullptr; }
+        inline const Ref<VulkanShaderObjects>& GetShaderObjects() const { return m_ShaderObjects; }
+
+        bool IsValid() const;
 
         void Bind(const VkCommandBuffer& cmd) const;
         void SetViewport(const VkCommandBuffer& cmd, const VkViewport& viewport);
         void SetScissor(const VkCommandBuffer& cmd, const VkRect2D& scissor);
 
+        static ShaderReflection Reflect(const Config& cfg);
+        static VkPipelineLayout ResolveLayout(const Config& cfg, const ShaderReflection& reflection, VulkanLayoutCache& layoutCache);
+        static std::vector<VkDynamicState> GetDynamicStates(const Ref<VulkanContext>& context, const Config& cfg);
+        static void GetVertexInput(
+            const Config& cfg,
+            const ShaderReflection& reflection,
+            std::vector<VkVertexInputBindingDescription>& bindings,
+            std::vector<VkVertexInputAttributeDescription>& attributes
+        );
+
+        static bool UsesShaderObjects(const Ref<VulkanContext>& context, const Config& cfg);
+        static Ref<VulkanShaderObjects> CreateShaderObjects(
+            const Ref<VulkanContext>& context,
+            const Config& cfg,
+            const ShaderReflection& reflection,
+            VulkanLayoutCache& layoutCache
+        );
+
+        static VkPipeline CreatePipeline(
+            const Ref<VulkanContext>& context,
+            const Config& cfg,
+            const ShaderReflection& reflection,
+            VkPipelineLayout layout,
+            VkGraphicsPipelineLibraryFlagsEXT parts,
+            VkPipelineCache pipelineCache
+        );
+
+    private:
+        void InitShaderObjects(const Config& cfg, const ShaderReflection& reflection, const Ref<VulkanShaderObjects>& shaderObjects);
+
     private:
         Ref<VulkanContext> m_Context;
 
         VkPipelineLayout m_Layout { VK_NULL_HANDLE };
+        bool m_OwnsLayout { true };
         VkPipeline m_Pipeline { VK_NULL_HANDLE };
+        bool m_DynamicState { false };
+
+        Ref<VulkanShaderObjects> m_ShaderObjects;
+        std::vector<VkVertexInputBindingDescription2EXT> m_VertexBindings;
+        std::vector<VkVertexInputAttributeDescription2EXT> m_VertexAttributes;
+        VkSampleCountFlagBits m_RasterSamples { VK_SAMPLE_COUNT_1_BIT };
+        f32 m_LineWidth { 1.0f };
     };
 
 }
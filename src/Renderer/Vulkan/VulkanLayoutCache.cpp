@@ -0,0 +1,142 @@
+#include "VulkanLayoutCache.hpp"
+
+#include <algorithm>
+
+namespace Renderer {
+
+    VulkanLayoutCache::VulkanLayoutCache(const Ref<VulkanContext>& context)
+        : m_Context(context)
+    {
+    }
+
+    VulkanLayoutCache::~VulkanLayoutCache()
+    {
+        for (auto& [_, layout] : m_PipelineLayouts)
+            vkDestroyPipelineLayout(m_Context->GetDevice(), layout, nullptr);
+
+        for (auto& [_, layout] : m_SetLayouts)
+            vkDestroyDescriptorSetLayout(m_Context->GetDevice(), layout, nullptr);
+    }
+
+    VkDescriptorSetLayout VulkanLayoutCache::GetDescriptorSetLayout(std::span<const VkDescriptorSetLayoutBinding> bindings)
+    {
+        std::vector<VkDescriptorSetLayoutBinding> sorted(bindings.begin(), bindings.end());
+        std::sort(sorted.begin(), sorted.end(), [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) {
+            return a.binding < b.binding;
+        });
+
+        std::vector<u64> key;
+        key.reserve(sorted.size() * 4);
+        for (const auto& binding : sorted) {
+            key.push_back(binding.binding);
+            key.push_back(static_cast<u64>(binding.descriptorType));
+            key.push_back(binding.descriptorCount);
+            key.push_back(binding.stageFlags);
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_SetLayouts.find(key);
+        if (it != m_SetLayouts.end())
+            return it->second;
+
+        VkDescriptorSetLayoutCreateInfo createInfo {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .bindingCount = static_cast<u32>(sorted.size()),
+            .pBindings = sorted.data()
+        };
+
+        VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+        VK_CHECK(vkCreateDescriptorSetLayout(m_Context->GetDevice(), &createInfo, nullptr, &layout));
+
+        m_SetLayouts.emplace(std::move(key), layout);
+        return layout;
+    }
+
+    VkPipelineLayout VulkanLayoutCache::GetPipelineLayout(std::span<const VkDescriptorSetLayout> setLayouts, std::span<const VkPushConstantRange> pushConstantRanges)
+    {
+        // Set layouts come from this cache, so equal handles mean equal
+        // contents and the handles themselves can form the key.
+        std::vector<u64> key;
+        key.reserve(1 + setLayouts.size() + pushConstantRanges.size() * 3);
+        key.push_back(setLayouts.size());
+        for (const auto& setLayout : setLayouts)
+            key.push_back(HandleKey(setLayout));
+        for (const auto& range : pushConstantRanges) {
+            key.push_back(range.stageFlags);
+            key.push_back(range.offset);
+            key.push_back(range.size);
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_PipelineLayouts.find(key);
+        if (it != m_PipelineLayouts.end())
+            return it->second;
+
+        VkPipelineLayoutCreateInfo createInfo {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .setLayoutCount = static_cast<u32>(setLayouts.size()),
+            .pSetLayouts = setLayouts.data(),
+            .pushConstantRangeCount = static_cast<u32>(pushConstantRanges.size()),
+            .pPushConstantRanges = pushConstantRanges.data()
+        };
+
+        VkPipelineLayout layout = VK_NULL_HANDLE;
+        VK_CHECK(vkCreatePipelineLayout(m_Context->GetDevice(), &createInfo, nullptr, &layout));
+
+        m_PipelineLayouts.emplace(std::move(key), layout);
+        return layout;
+    }
+
+    std::vector<VkDescriptorSetLayout> VulkanLayoutCache::GetDescriptorSetLayouts(const ShaderReflection& reflection)
+    {
+        // Sets without bindings still need a layout so that later set indices
+        // stay valid.
+        std::vector<std::vector<VkDescriptorSetLayoutBinding>> sets(reflection.GetSetCount());
+        for (const auto& binding : reflection.bindings) {
+            sets[binding.set].push_back(VkDescriptorSetLayoutBinding {
+                .binding = binding.binding,
+                .descriptorType = binding.type,
+                .descriptorCount = binding.count,
+                .stageFlags = binding.stages,
+                .pImmutableSamplers = nullptr
+            });
+        }
+
+        std::vector<VkDescriptorSetLayout> layouts;
+        layouts.reserve(sets.size());
+        for (const auto& bindings : sets)
+            layouts.push_back(GetDescriptorSetLayout(bindings));
+
+        return layouts;
+    }
+
+    VkPipelineLayout VulkanLayoutCache::GetPipelineLayout(const ShaderReflection& reflection)
+    {
+        std::vector<VkDescriptorSetLayout> setLayouts = GetDescriptorSetLayouts(reflection);
+
+        std::vector<VkPushConstantRange> pushConstantRanges;
+        if (reflection.pushConstants.has_value())
+            pushConstantRanges.push_back(reflection.pushConstants.value());
+
+        return GetPipelineLayout(setLayouts, pushConstantRanges);
+    }
+
+    usize VulkanLayoutCache::GetDescriptorSetLayoutCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_SetLayouts.size();
+    }
+
+    usize VulkanLayoutCache::GetPipelineLayoutCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_PipelineLayouts.size();
+    }
+
+}
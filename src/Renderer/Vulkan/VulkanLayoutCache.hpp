@@ -0,0 +1,46 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "VulkanTypes.hpp"
+#include "VulkanContext.hpp"
+#include "VulkanShaderReflection.hpp"
+
+namespace Renderer {
+
+    class VulkanLayoutCache
+    {
+    public:
+        VulkanLayoutCache(const Ref<VulkanContext>& context);
+        ~VulkanLayoutCache();
+
+        VkDescriptorSetLayout GetDescriptorSetLayout(std::span<const VkDescriptorSetLayoutBinding> bindings);
+        VkPipelineLayout GetPipelineLayout(std::span<const VkDescriptorSetLayout> setLayouts, std::span<const VkPushConstantRange> pushConstantRanges);
+
+        std::vector<VkDescriptorSetLayout> GetDescriptorSetLayouts(const ShaderReflection& reflection);
+        VkPipelineLayout GetPipelineLayout(const ShaderReflection& reflection);
+
+        usize GetDescriptorSetLayoutCount() const;
+        usize GetPipelineLayoutCount() const;
+
+        template <typename T>
+        static u64 HandleKey(T handle)
+        {
+            if constexpr (std::is_pointer_v<T>)
+                return static_cast<u64>(reinterpret_cast<uintptr_t>(handle));
+            else
+                return static_cast<u64>(handle);
+        }
+
+    private:
+        Ref<VulkanContext> m_Context;
+
+        mutable std::mutex m_Mutex;
+        std::map<std::vector<u64>, VkDescriptorSetLayout> m_SetLayouts;
+        std::map<std::vector<u64>, VkPipelineLayout> m_PipelineLayouts;
+    };
+
+}
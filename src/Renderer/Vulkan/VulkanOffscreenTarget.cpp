@@ -0,0 +1,151 @@
+#include "VulkanOffscreenTarget.hpp"
+
+namespace Renderer {
+
+    VulkanOffscreenTarget::VulkanOffscreenTarget(const Ref<VulkanContext>& context, const Config& config)
+        : m_Context(context), m_Config(config)
+    {
+        CreateImages();
+    }
+
+    VulkanOffscreenTarget::~VulkanOffscreenTarget()
+    {
+        CleanupImages();
+    }
+
+    bool VulkanOffscreenTarget::AcquireNextImage()
+    {
+        if (m_Images.empty()) {
+            LOG_ERROR("Offscreen target not created")
+            return false;
+        }
+
+        m_CurrentImageIndex = (m_CurrentImageIndex + 1) % GetImageCount();
+        return true;
+    }
+
+    void VulkanOffscreenTarget::Recreate(VkExtent2D extent, VulkanDeletionQueue* deletionQueue)
+    {
+        m_Config.extent = extent;
+
+        CleanupImages(deletionQueue);
+        CreateImages();
+    }
+
+    void VulkanOffscreenTarget::CreateImages()
+    {
+        m_CurrentImageIndex = 0;
+
+        m_Images.resize(m_Config.imageCount, VK_NULL_HANDLE);
+        m_Memory.resize(m_Config.imageCount, VK_NULL_HANDLE);
+        m_ImageViews.resize(m_Config.imageCount, VK_NULL_HANDLE);
+
+        for (usize i = 0; i < m_Config.imageCount; ++i) {
+            VkImageCreateInfo imageInfo {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                .pNext = nullptr,
+                .flags = 0,
+                .imageType = VK_IMAGE_TYPE_2D,
+                .format = m_Config.format,
+                .extent = {
+                    .width = m_Config.extent.width,
+                    .height = m_Config.extent.height,
+                    .depth = 1
+                },
+                .mipLevels = 1,
+                .arrayLayers = 1,
+                .samples = VK_SAMPLE_COUNT_1_BIT,
+                .tiling = VK_IMAGE_TILING_OPTIMAL,
+                .usage = m_Config.imageUsage,
+                .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                .queueFamilyIndexCount = 0,
+                .pQueueFamilyIndices = nullptr,
+                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+            };
+
+            VK_CHECK(vkCreateImage(m_Context->GetDevice(), &imageInfo, nullptr, &m_Images.at(i)));
+
+            VkMemoryRequirements requirements;
+            vkGetImageMemoryRequirements(m_Context->GetDevice(), m_Images.at(i), &requirements);
+
+            auto memoryType = m_Context->FindMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            if (!memoryType.has_value())
+                memoryType = m_Context->FindMemoryType(requirements.memoryTypeBits, 0);
+
+            VkMemoryAllocateInfo allocInfo {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+                .pNext = nullptr,
+                .allocationSize = requirements.size,
+                .memoryTypeIndex = memoryType.value()
+            };
+
+            VK_CHECK(vkAllocateMemory(m_Context->GetDevice(), &allocInfo, nullptr, &m_Memory.at(i)));
+            VK_CHECK(vkBindImageMemory(m_Context->GetDevice(), m_Images.at(i), m_Memory.at(i), 0));
+
+            VkImageViewCreateInfo viewInfo {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+                .pNext = nullptr,
+                .flags = 0,
+                .image = m_Images.at(i),
+                .viewType = VK_IMAGE_VIEW_TYPE_2D,
+                .format = m_Config.format,
+                .components = {
+                    .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+                    .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+                    .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+                    .a = VK_COMPONENT_SWIZZLE_IDENTITY
+                },
+                .subresourceRange = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .baseMipLevel = 0,
+                    .levelCount = 1,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1
+                }
+            };
+
+            VK_CHECK(vkCreateImageView(m_Context->GetDevice(), &viewInfo, nullptr, &m_ImageViews.at(i)));
+        }
+
+        LOG_INFO("Created {} offscreen targets ({}, {})", m_Config.imageCount, m_Config.extent.width, m_Config.extent.height)
+    }
+
+    void VulkanOffscreenTarget::CleanupImages(VulkanDeletionQueue* deletionQueue)
+    {
+        if (deletionQueue) {
+            deletionQueue->Defer([context = m_Context, views = std::move(m_ImageViews), images = std::move(m_Images), memory = std::move(m_Memory)]() {
+                for (const auto& view : views)
+                    vkDestroyImageView(context->GetDevice(), view, nullptr);
+                for (const auto& image : images)
+                    vkDestroyImage(context->GetDevice(), image, nullptr);
+                for (const auto& allocation : memory)
+                    vkFreeMemory(context->GetDevice(), allocation, nullptr);
+            });
+
+            m_ImageViews.clear();
+            m_Images.clear();
+            m_Memory.clear();
+            return;
+        }
+
+        for (auto& view : m_ImageViews) {
+            if (view != VK_NULL_HANDLE)
+                vkDestroyImageView(m_Context->GetDevice(), view, nullptr);
+        }
+
+        for (auto& image : m_Images) {
+            if (image != VK_NULL_HANDLE)
+                vkDestroyImage(m_Context->GetDevice(), image, nullptr);
+        }
+
+        for (auto& memory : m_Memory) {
+            if (memory != VK_NULL_HANDLE)
+                vkFreeMemory(m_Context->GetDevice(), memory, nullptr);
+        }
+
+        m_ImageViews.clear();
+        m_Images.clear();
+        m_Memory.clear();
+    }
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+
+#include "VulkanTypes.hpp"
+#include "VulkanContext.hpp"
+#include "VulkanDeletionQueue.hpp"
+
+namespace Renderer {
+
+    class VulkanOffscreenTarget
+    {
+    public:
+        struct Config
+        {
+            VkExtent2D extent { 1280, 720 };
+            VkFormat format { VK_FORMAT_R8G8B8A8_UNORM };
+            u32 imageCount { 2 };
+            VkImageUsageFlags imageUsage { VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT };
+        };
+
+    public:
+        VulkanOffscreenTarget(const Ref<VulkanContext>& context, const Config& config);
+        ~VulkanOffscreenTarget();
+
+        inline const std::vector<VkImage>& GetImages() const { return m_Images; }
+        inline const std::vector<VkImageView>& GetImageViews() const { return m_ImageViews; }
+        inline u32 GetImageCount() const { return static_cast<u32>(m_Images.size()); }
+
+        inline const VkFormat& GetFormat() const { return m_Config.format; }
+
+        inline const VkExtent2D GetExtent() const { return m_Config.extent; }
+        inline u32 GetWidth() const { return m_Config.extent.width; }
+        inline u32 GetHeight() const { return m_Config.extent.height; }
+
+        inline u32 GetCurrentImageIndex() const { return m_CurrentImageIndex; }
+        inline const VkImage& GetCurrentImage() const { return m_Images[m_CurrentImageIndex]; }
+        inline const VkImageView& GetCurrentImageView() const { return m_ImageViews[m_CurrentImageIndex]; }
+
+        bool AcquireNextImage();
+
+        void Recreate(VkExtent2D extent, VulkanDeletionQueue* deletionQueue = nullptr);
+
+    private:
+        void CreateImages();
+        void CleanupImages(VulkanDeletionQueue* deletionQueue = nullptr);
+
+    private:
+        Ref<VulkanContext> m_Context;
+        Config m_Config;
+
+        u32 m_CurrentImageIndex { 0 };
+
+        std::vector<VkImage> m_Images;
+        std::vector<VkDeviceMemory> m_Memory;
+        std::vector<VkImageView> m_ImageViews;
+    };
+
+}
@@ -0,0 +1,205 @@
+#include "VulkanPipelineCompiler.hpp"
+
+#include <algorithm>
+
+#include "Core/Profiler.hpp"
+
+namespace Renderer {
+
+    VulkanAsyncPipeline::VulkanAsyncPipeline(const Ref<VulkanAsyncPipeline>& fallback)
+        : m_Fallback(fallback)
+    {
+    }
+
+    Ref<VulkanGraphicsPipeline> VulkanAsyncPipeline::Get() const
+    {
+        if (auto pipeline = m_Pipeline.load(std::memory_order_acquire))
+            return pipeline;
+
+        if (auto pipeline = m_Linked.load(std::memory_order_acquire))
+            return pipeline;
+
+        return m_Fallback ? m_Fallback->Get() : nullptr;
+    }
+
+    VulkanPipelineCompiler::VulkanPipelineCompiler(const Ref<VulkanContext>& context, VulkanLayoutCache& layoutCache, const Config& config)
+        : m_Context(context), m_LayoutCache(layoutCache)
+    {
+        // Pipeline caches are internally synchronised, so every worker shares
+        // this one and benefits from what the others have compiled.
+        VkPipelineCacheCreateInfo cacheInfo {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .initialDataSize = 0,
+            .pInitialData = nullptr
+        };
+
+        VK_CHECK(vkCreatePipelineCache(m_Context->GetDevice(), &cacheInfo, nullptr, &m_PipelineCache));
+
+        if (m_Context->SupportsGraphicsPipelineLibrary())
+            m_Library = CreateScope<VulkanPipelineLibrary>(m_Context, m_LayoutCache, m_PipelineCache);
+
+        if (m_Context->SupportsShaderObject())
+            m_ShaderObjectCache = CreateScope<VulkanShaderObjectCache>(m_Context, m_LayoutCache);
+
+        u32 workerCount = config.workerCount;
+        if (workerCount == 0)
+            workerCount = std::clamp(std::thread::hardware_concurrency() / 4, 1u, 4u);
+
+        for (u32 i = 0; i < workerCount; ++i)
+            m_Workers.emplace_back(&VulkanPipelineCompiler::WorkerLoop, this);
+    }
+
+    VulkanPipelineCompiler::~VulkanPipelineCompiler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stop = true;
+            m_Queue.clear();
+        }
+        m_Condition.notify_all();
+
+        for (auto& worker : m_Workers) {
+            if (worker.joinable())
+                worker.join();
+        }
+
+        m_Library.reset();
+        m_ShaderObjectCache.reset();
+
+        if (m_PipelineCache != VK_NULL_HANDLE)
+            vkDestroyPipelineCache(m_Context->GetDevice(), m_PipelineCache, nullptr);
+    }
+
+    Ref<VulkanAsyncPipeline> VulkanPipelineCompiler::Compile(const VulkanGraphicsPipeline::Config& cfg, const Ref<VulkanAsyncPipeline>& fallback)
+    {
+        auto target = CreateRef<VulkanAsyncPipeline>(fallback);
+
+        // Shader objects hold no state, so once a config's shaders are
+        // compiled any state combination for them is ready immediately.
+        if (VulkanGraphicsPipeline::UsesShaderObjects(m_Context, cfg)) {
+            if (m_ShaderObjectCache->Contains(cfg)) {
+                target->m_Pipeline.store(m_ShaderObjectCache->Create(cfg), std::memory_order_release);
+                target->m_State.store(VulkanAsyncPipeline::State::Ready, std::memory_order_release);
+                return target;
+            }
+
+            Enqueue(Job { .config = cfg, .target = target, .optimize = false });
+            return target;
+        }
+
+        // With every part library already compiled, linking is cheap enough
+        // to do right here; only the optimized link goes to the workers.
+        if (m_Library && m_Library->Contains(cfg)) {
+            target->m_Linked.store(m_Library->Link(cfg, false), std::memory_order_release);
+            target->m_State.store(VulkanAsyncPipeline::State::Linked, std::memory_order_release);
+            Enqueue(Job { .config = cfg, .target = target, .optimize = true });
+            return target;
+        }
+
+        Enqueue(Job { .config = cfg, .target = target, .optimize = false });
+        return target;
+    }
+
+    Ref<VulkanGraphicsPipeline> VulkanPipelineCompiler::CompileNow(const VulkanGraphicsPipeline::Config& cfg)
+    {
+        PROFILE_SCOPE("VulkanPipelineCompiler::CompileNow")
+
+        if (VulkanGraphicsPipeline::UsesShaderObjects(m_Context, cfg))
+            return m_ShaderObjectCache->Create(cfg);
+
+        return CreateRef<VulkanGraphicsPipeline>(m_Context, cfg, m_LayoutCache, m_PipelineCache);
+    }
+
+    void VulkanPipelineCompiler::Enqueue(Job job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Queue.push_back(std::move(job));
+        }
+        m_Condition.notify_one();
+    }
+
+    usize VulkanPipelineCompiler::GetPendingCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Queue.size() + m_Active;
+    }
+
+    void VulkanPipelineCompiler::WaitIdle()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_IdleCondition.wait(lock, [this]{
+            return m_Queue.empty() && m_Active == 0;
+        });
+    }
+
+    void VulkanPipelineCompiler::WorkerLoop()
+    {
+        PROFILE_THREAD("Pipeline Compiler")
+
+        while (true) {
+            Job job;
+
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Condition.wait(lock, [this]{
+                    return !m_Queue.empty() || m_Stop;
+                });
+
+                if (m_Stop)
+                    break;
+
+                job = std::move(m_Queue.front());
+                m_Queue.pop_front();
+                ++m_Active;
+            }
+
+            {
+                PROFILE_SCOPE("VulkanPipelineCompiler::Compile")
+
+                bool shaderObjects = VulkanGraphicsPipeline::UsesShaderObjects(m_Context, job.config);
+                bool link = m_Library && !shaderObjects;
+
+                i64 startNs = Profiler::Now();
+                Ref<VulkanGraphicsPipeline> pipeline;
+                if (shaderObjects)
+                    pipeline = m_ShaderObjectCache->Create(job.config);
+                else if (!link)
+                    pipeline = CreateRef<VulkanGraphicsPipeline>(m_Context, job.config, m_LayoutCache, m_PipelineCache);
+                else
+                    pipeline = m_Library->Link(job.config, job.optimize);
+                f64 elapsedMs = static_cast<f64>(Profiler::Now() - startNs) / 1'000'000.0;
+                (void)elapsedMs;
+
+                // The unoptimized link stays alive alongside the optimized
+                // pipeline, as frames in flight may still be using it.
+                if (link && !job.optimize && pipeline->IsValid()) {
+                    job.target->m_Linked.store(pipeline, std::memory_order_release);
+                    job.target->m_State.store(VulkanAsyncPipeline::State::Linked, std::memory_order_release);
+                    LOG_INFO("Linked pipeline libraries in {:.2f} ms", elapsedMs)
+
+                    job.optimize = true;
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+                    if (!m_Stop)
+                        m_Queue.push_back(std::move(job));
+                } else if (pipeline->IsValid()) {
+                    job.target->m_Pipeline.store(pipeline, std::memory_order_release);
+                    job.target->m_State.store(VulkanAsyncPipeline::State::Ready, std::memory_order_release);
+                    LOG_INFO("Compiled pipeline in {:.2f} ms", elapsedMs)
+                } else {
+                    job.target->m_State.store(VulkanAsyncPipeline::State::Failed, std::memory_order_release);
+                    LOG_ERROR("Failed to compile pipeline")
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                --m_Active;
+            }
+            m_IdleCondition.notify_all();
+        }
+    }
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "VulkanTypes.hpp"
+#include "VulkanContext.hpp"
+#include "VulkanGraphicsPipeline.hpp"
+#include "VulkanLayoutCache.hpp"
+#include "VulkanPipelineLibrary.hpp"
+#include "VulkanShaderObjectCache.hpp"
+
+namespace Renderer {
+
+    class VulkanAsyncPipeline
+    {
+    public:
+        enum class State
+        {
+            Pending,
+            Linked,
+            Ready,
+            Failed
+        };
+
+    public:
+        VulkanAsyncPipeline(const Ref<VulkanAsyncPipeline>& fallback);
+
+        inline State GetState() const { return m_State.load(std::memory_order_acquire); }
+        inline bool IsReady() const { return GetState() == State::Ready; }
+
+        Ref<VulkanGraphicsPipeline> Get() const;
+
+    private:
+        friend class VulkanPipelineCompiler;
+
+        std::atomic<Ref<VulkanGraphicsPipeline>> m_Pipeline;
+        std::atomic<Ref<VulkanGraphicsPipeline>> m_Linked;
+        std::atomic<State> m_State { State::Pending };
+        Ref<VulkanAsyncPipeline> m_Fallback;
+    };
+
+    class VulkanPipelineCompiler
+    {
+    public:
+        struct Config
+        {
+            u32 workerCount { 0 };
+        };
+
+    public:
+        VulkanPipelineCompiler(const Ref<VulkanContext>& context, VulkanLayoutCache& layoutCache, const Config& config);
+        ~VulkanPipelineCompiler();
+
+        inline const VkPipelineCache& GetPipelineCache() const { return m_PipelineCache; }
+        inline bool UsesPipelineLibraries() const { return m_Library != nullptr; }
+        inline bool UsesShaderObjects() const { return m_ShaderObjectCache != nullptr; }
+
+        Ref<VulkanAsyncPipeline> Compile(const VulkanGraphicsPipeline::Config& cfg, const Ref<VulkanAsyncPipeline>& fallback = nullptr);
+        Ref<VulkanGraphicsPipeline> CompileNow(const VulkanGraphicsPipeline::Config& cfg);
+
+        usize GetPendingCount() const;
+        void WaitIdle();
+
+    private:
+        struct Job
+        {
+            VulkanGraphicsPipeline::Config config;
+            Ref<VulkanAsyncPipeline> target;
+            bool optimize { false };
+        };
+
+    private:
+        void Enqueue(Job job);
+        void WorkerLoop();
+
+    private:
+        Ref<VulkanContext> m_Context;
+        VulkanLayoutCache& m_LayoutCache;
+
+        VkPipelineCache m_PipelineCache { VK_NULL_HANDLE };
+        Scope<VulkanPipelineLibrary> m_Library;
+        Scope<VulkanShaderObjectCache> m_ShaderObjectCache;
+
+        std::vector<std::thread> m_Workers;
+        mutable std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        std::condition_variable m_IdleCondition;
+        std::deque<Job> m_Queue;
+        usize m_Active { 0 };
+        bool m_Stop { false };
+    };
+
+}
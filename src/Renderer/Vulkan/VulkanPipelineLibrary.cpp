@@ -0,0 +1,210 @@
+#include "VulkanPipelineLibrary.hpp"
+
+#include <bit>
+
+#include "Core/Profiler.hpp"
+
+namespace Renderer {
+
+    VulkanPipelineLibrary::VulkanPipelineLibrary(const Ref<VulkanContext>& context, VulkanLayoutCache& layoutCache, VkPipelineCache pipelineCache)
+        : m_Context(context), m_LayoutCache(layoutCache), m_PipelineCache(pipelineCache)
+    {
+    }
+
+    VulkanPipelineLibrary::~VulkanPipelineLibrary()
+    {
+        Clear();
+    }
+
+    bool VulkanPipelineLibrary::Contains(const VulkanGraphicsPipeline::Config& cfg) const
+    {
+        ShaderReflection reflection = VulkanGraphicsPipeline::Reflect(cfg);
+        VkPipelineLayout layout = VulkanGraphicsPipeline::ResolveLayout(cfg, reflection, m_LayoutCache);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (VkGraphicsPipelineLibraryFlagsEXT part : s_Parts) {
+            if (!m_Libraries.contains(MakeKey(part, cfg, reflection, layout)))
+                return false;
+        }
+        return true;
+    }
+
+    Ref<VulkanGraphicsPipeline> VulkanPipelineLibrary::Link(const VulkanGraphicsPipeline::Config& cfg, bool optimize)
+    {
+        PROFILE_SCOPE("VulkanPipelineLibrary::Link")
+
+        ShaderReflection reflection = VulkanGraphicsPipeline::Reflect(cfg);
+        VkPipelineLayout layout = VulkanGraphicsPipeline::ResolveLayout(cfg, reflection, m_LayoutCache);
+
+        std::array<VkPipeline, s_Parts.size()> libraries {};
+        for (usize i = 0; i < s_Parts.size(); ++i)
+            libraries[i] = GetLibrary(s_Parts[i], cfg, reflection, layout);
+
+        return CreateRef<VulkanGraphicsPipeline>(m_Context, cfg, layout, libraries, optimize, m_PipelineCache);
+    }
+
+    usize VulkanPipelineLibrary::GetLibraryCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Libraries.size();
+    }
+
+    void VulkanPipelineLibrary::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        // Linked pipelines do not reference their libraries, so these can go
+        // while pipelines built from them are still in use.
+        for (auto& [_, library] : m_Libraries)
+            vkDestroyPipeline(m_Context->GetDevice(), library, nullptr);
+
+        m_Libraries.clear();
+    }
+
+    VulkanPipelineLibrary::Key VulkanPipelineLibrary::MakeKey(
+        VkGraphicsPipelineLibraryFlagsEXT part,
+        const VulkanGraphicsPipeline::Config& cfg,
+        const ShaderReflection& reflection,
+        VkPipelineLayout layout
+    ) const
+    {
+        // Each key only holds the state its part consumes, so configs that
+        // differ elsewhere share the library. State set per draw is left out
+        // as well, except the topology class, which must match the pipeline.
+        bool dynamic = cfg.dynamicState;
+        bool dynamic3 = dynamic && m_Context->SupportsExtendedDynamicState3();
+
+        Key key { part, dynamic, dynamic3 };
+
+        switch (part) {
+            case VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT:
+                key.push_back(dynamic ? static_cast<u64>(TopologyClass(cfg.topology)) : static_cast<u64>(cfg.topology));
+                for (const auto& binding : cfg.vertexBindingDescriptions) {
+                    key.push_back(binding.binding);
+                    key.push_back(binding.stride);
+                    key.push_back(static_cast<u64>(binding.inputRate));
+                }
+                for (const auto& attribute : cfg.vertexAttributeDescriptions) {
+                    key.push_back(attribute.location);
+                    key.push_back(attribute.binding);
+                    key.push_back(static_cast<u64>(attribute.format));
+                    key.push_back(attribute.offset);
+                }
+                if (cfg.vertexBindingDescriptions.empty() && cfg.vertexAttributeDescriptions.empty()) {
+                    for (const auto& input : reflection.vertexInputs) {
+                        key.push_back(input.location);
+                        key.push_back(static_cast<u64>(input.format));
+                    }
+                }
+                break;
+
+            case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+                key.push_back(VulkanLayoutCache::HandleKey(layout));
+                for (const auto& shader : cfg.shaders) {
+                    if (shader->GetStage() == VK_SHADER_STAGE_FRAGMENT_BIT)
+                        continue;
+                    key.push_back(static_cast<u64>(shader->GetStage()));
+                    key.push_back(shader->GetHash());
+                    if (auto it = cfg.specialization.find(shader->GetStage()); it != cfg.specialization.end())
+                        it->second.AppendKey(key);
+                }
+                if (!dynamic3)
+                    key.push_back(static_cast<u64>(cfg.polygonMode));
+                if (!dynamic) {
+                    key.push_back(cfg.cullMode);
+                    key.push_back(static_cast<u64>(cfg.frontFace));
+                }
+                key.push_back(std::bit_cast<u32>(cfg.lineWidth));
+                break;
+
+            case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT:
+                key.push_back(VulkanLayoutCache::HandleKey(layout));
+                for (const auto& shader : cfg.shaders) {
+                    if (shader->GetStage() == VK_SHADER_STAGE_FRAGMENT_BIT)
+                        key.push_back(shader->GetHash());
+                }
+                if (auto it = cfg.specialization.find(VK_SHADER_STAGE_FRAGMENT_BIT); it != cfg.specialization.end())
+                    it->second.AppendKey(key);
+                key.push_back(static_cast<u64>(cfg.rasterSamples));
+                if (!dynamic) {
+                    key.push_back(cfg.depthTestEnabled);
+                    key.push_back(cfg.depthWriteEnabled);
+                    key.push_back(static_cast<u64>(cfg.depthCompareOp));
+                }
+                break;
+
+            case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT:
+                key.push_back(static_cast<u64>(cfg.rasterSamples));
+                for (VkFormat format : cfg.colorAttachmentFormats)
+                    key.push_back(static_cast<u64>(format));
+                key.push_back(static_cast<u64>(cfg.depthAttachmentFormat));
+                key.push_back(static_cast<u64>(cfg.stencilAttachmentFormat));
+                key.push_back(cfg.colorBlendAttachments.size());
+                for (const auto& attachment : cfg.colorBlendAttachments) {
+                    if (dynamic3)
+                        break;
+
+                    key.push_back(attachment.blendEnable);
+                    key.push_back(static_cast<u64>(attachment.srcColorBlendFactor));
+                    key.push_back(static_cast<u64>(attachment.dstColorBlendFactor));
+                    key.push_back(static_cast<u64>(attachment.colorBlendOp));
+                    key.push_back(static_cast<u64>(attachment.srcAlphaBlendFactor));
+                    key.push_back(static_cast<u64>(attachment.dstAlphaBlendFactor));
+                    key.push_back(static_cast<u64>(attachment.alphaBlendOp));
+                    key.push_back(attachment.colorWriteMask);
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        return key;
+    }
+
+    u32 VulkanPipelineLibrary::TopologyClass(VkPrimitiveTopology topology)
+    {
+        switch (topology) {
+            case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+                return 0;
+            case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+            case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+            case VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY:
+            case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY:
+                return 1;
+            case VK_PRIMITIVE_TOPOLOGY_PATCH_LIST:
+                return 3;
+            default:
+                return 2;
+        }
+    }
+
+    VkPipeline VulkanPipelineLibrary::GetLibrary(
+        VkGraphicsPipelineLibraryFlagsEXT part,
+        const VulkanGraphicsPipeline::Config& cfg,
+        const ShaderReflection& reflection,
+        VkPipelineLayout layout
+    )
+    {
+        Key key = MakeKey(part, cfg, reflection, layout);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            auto it = m_Libraries.find(key);
+            if (it != m_Libraries.end())
+                return it->second;
+        }
+
+        // Compiled outside the lock so workers can build different parts in
+        // parallel; a racing duplicate is discarded.
+        VkPipeline library = VulkanGraphicsPipeline::CreatePipeline(m_Context, cfg, reflection, layout, part, m_PipelineCache);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto [it, inserted] = m_Libraries.emplace(std::move(key), library);
+        if (!inserted)
+            vkDestroyPipeline(m_Context->GetDevice(), library, nullptr);
+
+        return it->second;
+    }
+
+}
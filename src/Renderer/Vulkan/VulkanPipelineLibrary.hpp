@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "VulkanTypes.hpp"
+#include "VulkanContext.hpp"
+#include "VulkanGraphicsPipeline.hpp"
+#include "VulkanLayoutCache.hpp"
+
+namespace Renderer {
+
+    class VulkanPipelineLibrary
+    {
+    public:
+        VulkanPipelineLibrary(const Ref<VulkanContext>& context, VulkanLayoutCache& layoutCache, VkPipelineCache pipelineCache);
+        ~VulkanPipelineLibrary();
+
+        bool Contains(const VulkanGraphicsPipeline::Config& cfg) const;
+        Ref<VulkanGraphicsPipeline> Link(const VulkanGraphicsPipeline::Config& cfg, bool optimize);
+
+        usize GetLibraryCount() const;
+        void Clear();
+
+    private:
+        using Key = std::vector<u64>;
+
+        Key MakeKey(
+            VkGraphicsPipelineLibraryFlagsEXT part,
+            const VulkanGraphicsPipeline::Config& cfg,
+            const ShaderReflection& reflection,
+            VkPipelineLayout layout
+        ) const;
+
+        static u32 TopologyClass(VkPrimitiveTopology topology);
+
+        VkPipeline GetLibrary(
+            VkGraphicsPipelineLibraryFlagsEXT part,
+            const VulkanGraphicsPipeline::Config& cfg,
+            const ShaderReflection& reflection,
+            VkPipelineLayout layout
+        );
+
+    private:
+        static constexpr std::array<VkGraphicsPipelineLibraryFlagsEXT, 4> s_Parts {
+            VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+            VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+            VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+            VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT
+        };
+
+        Ref<VulkanContext> m_Context;
+        VulkanLayoutCache& m_LayoutCache;
+        VkPipelineCache m_PipelineCache { VK_NULL_HANDLE };
+
+        mutable std::mutex m_Mutex;
+        std::map<Key, VkPipeline> m_Libraries;
+    };
+
+}
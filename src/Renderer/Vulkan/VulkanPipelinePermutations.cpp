@@ -0,0 +1,168 @@
+#include "VulkanPipelinePermutations.hpp"
+
+#include <algorithm>
+
+namespace Renderer {
+
+    VulkanPipelinePermutations::VulkanPipelinePermutations(VulkanPipelineCompiler& compiler, const VulkanGraphicsPipeline::Config& base)
+        : m_Compiler(compiler), m_Base(base)
+    {
+    }
+
+    u32 VulkanPipelinePermutations::AddOption(const Option& option)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        Option& added = m_Options.emplace_back(option);
+        if (added.values.empty())
+            added.values.push_back(0);
+
+        // Pipelines compiled so far were built without this constant.
+        m_Pipelines.clear();
+
+        return static_cast<u32>(m_Options.size() - 1);
+    }
+
+    std::vector<VulkanPipelinePermutations::Option> VulkanPipelinePermutations::GetOptions() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Options;
+    }
+
+    VulkanPipelinePermutations::Selection VulkanPipelinePermutations::GetDefaultSelection() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        Selection selection;
+        selection.reserve(m_Options.size());
+        for (const auto& option : m_Options)
+            selection.push_back(option.values.front());
+        return selection;
+    }
+
+    u32 VulkanPipelinePermutations::SelectBucket(u32 option, u32 value) const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        // Buckets round up, e.g. 11 lights run the 16 light variant; values
+        // above the largest bucket clamp to it.
+        const auto& values = m_Options.at(option).values;
+        u32 best = *std::max_element(values.begin(), values.end());
+        for (u32 candidate : values) {
+            if (candidate >= value && candidate < best)
+                best = candidate;
+        }
+        return best;
+    }
+
+    Ref<VulkanAsyncPipeline> VulkanPipelinePermutations::Get(std::span<const u32> selection)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return GetLocked(selection);
+    }
+
+    void VulkanPipelinePermutations::Precompile()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        Selection selection(m_Options.size());
+        std::vector<usize> indices(m_Options.size(), 0);
+
+        while (true) {
+            for (usize i = 0; i < m_Options.size(); ++i)
+                selection[i] = m_Options[i].values[indices[i]];
+
+            GetLocked(selection);
+
+            usize i = 0;
+            for (; i < indices.size(); ++i) {
+                if (++indices[i] < m_Options[i].values.size())
+                    break;
+                indices[i] = 0;
+            }
+
+            if (i == indices.size())
+                break;
+        }
+    }
+
+    usize VulkanPipelinePermutations::GetPermutationCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        usize count = 1;
+        for (const auto& option : m_Options)
+            count *= option.values.size();
+        return count;
+    }
+
+    usize VulkanPipelinePermutations::GetCompiledCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Pipelines.size();
+    }
+
+    VulkanGraphicsPipeline::Config VulkanPipelinePermutations::MakeConfig(std::span<const u32> selection) const
+    {
+        VulkanGraphicsPipeline::Config cfg = m_Base;
+
+        for (usize i = 0; i < m_Options.size(); ++i) {
+            const Option& option = m_Options[i];
+            for (const auto& shader : cfg.shaders) {
+                if ((option.stages & shader->GetStage()) == 0)
+                    continue;
+
+                // Only stages that declare the constant get it, so a toggle
+                // that one stage ignores does not split its library key.
+                const auto& constants = shader->GetReflection().specializationConstants;
+                auto constant = std::find_if(constants.begin(), constants.end(), [&option](const auto& declared) {
+                    return declared.id == option.constantId;
+                });
+                if (constant == constants.end())
+                    continue;
+
+                // The value is written at the width the shader declares, so
+                // 64-bit constants do not read past a 32-bit entry.
+                auto& specialization = cfg.specialization[shader->GetStage()];
+                if (constant->size == sizeof(u64))
+                    specialization.Set(option.constantId, static_cast<u64>(selection[i]));
+                else
+                    specialization.Set(option.constantId, selection[i]);
+            }
+        }
+
+        return cfg;
+    }
+
+    Ref<VulkanAsyncPipeline> VulkanPipelinePermutations::GetLocked(std::span<const u32> selection)
+    {
+        Selection key(selection.begin(), selection.end());
+        key.resize(m_Options.size(), 0);
+
+        for (usize i = 0; i < m_Options.size(); ++i) {
+            const auto& values = m_Options[i].values;
+            if (std::find(values.begin(), values.end(), key[i]) == values.end()) {
+                LOG_WARN("Permutation option {} has no variant {}, using {}", m_Options[i].name, key[i], values.front())
+                key[i] = values.front();
+            }
+        }
+
+        if (auto it = m_Pipelines.find(key); it != m_Pipelines.end())
+            return it->second;
+
+        // New variants draw with the default one until they are compiled,
+        // rather than dropping the draw.
+        Ref<VulkanAsyncPipeline> fallback;
+        Selection defaults;
+        for (const auto& option : m_Options)
+            defaults.push_back(option.values.front());
+
+        if (key != defaults)
+            fallback = GetLocked(defaults);
+
+        auto pipeline = m_Compiler.Compile(MakeConfig(key), fallback);
+        m_Pipelines.emplace(std::move(key), pipeline);
+        return pipeline;
+    }
+
+}
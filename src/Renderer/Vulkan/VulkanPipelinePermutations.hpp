@@ -0,0 +1,59 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "VulkanTypes.hpp"
+#include "VulkanGraphicsPipeline.hpp"
+#include "VulkanPipelineCompiler.hpp"
+
+namespace Renderer {
+
+    class VulkanPipelinePermutations
+    {
+    public:
+        // Values are unsigned integers. They are passed to int, uint, bool
+        // and 64-bit integer constants; float constants are not supported.
+        struct Option
+        {
+            std::string name;
+            u32 constantId { 0 };
+            std::vector<u32> values;
+            VkShaderStageFlags stages { VK_SHADER_STAGE_ALL_GRAPHICS };
+        };
+
+        using Selection = std::vector<u32>;
+
+    public:
+        VulkanPipelinePermutations(VulkanPipelineCompiler& compiler, const VulkanGraphicsPipeline::Config& base);
+
+        u32 AddOption(const Option& option);
+        std::vector<Option> GetOptions() const;
+
+        Selection GetDefaultSelection() const;
+        u32 SelectBucket(u32 option, u32 value) const;
+
+        Ref<VulkanAsyncPipeline> Get(std::span<const u32> selection);
+        void Precompile();
+
+        usize GetPermutationCount() const;
+        usize GetCompiledCount() const;
+
+    private:
+        VulkanGraphicsPipeline::Config MakeConfig(std::span<const u32> selection) const;
+        Ref<VulkanAsyncPipeline> GetLocked(std::span<const u32> selection);
+
+    private:
+        VulkanPipelineCompiler& m_Compiler;
+        VulkanGraphicsPipeline::Config m_Base;
+
+        std::vector<Option> m_Options;
+
+        mutable std::mutex m_Mutex;
+        std::map<Selection, Ref<VulkanAsyncPipeline>> m_Pipelines;
+    };
+
+}
@@ -0,0 +1,174 @@
+#include "VulkanQueueSubmitter.hpp"
+
+#include "Core/Profiler.hpp"
+
+namespace Renderer {
+
+    VulkanQueueSubmitter::VulkanQueueSubmitter(const Ref<VulkanContext>& context, const DeviceQueue& queue)
+        : m_Context(context), m_Queue(queue)
+    {
+        VkSemaphoreTypeCreateInfo typeInfo {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+            .pNext = nullptr,
+            .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+            .initialValue = 0
+        };
+
+        VkSemaphoreCreateInfo semaphoreInfo {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+            .pNext = &typeInfo,
+            .flags = 0
+        };
+
+        VK_CHECK(vkCreateSemaphore(m_Context->GetDevice(), &semaphoreInfo, nullptr, &m_Timeline));
+    }
+
+    VulkanQueueSubmitter::~VulkanQueueSubmitter()
+    {
+        WaitIdle();
+
+        if (m_Timeline != VK_NULL_HANDLE)
+            vkDestroySemaphore(m_Context->GetDevice(), m_Timeline, nullptr);
+    }
+
+    u64 VulkanQueueSubmitter::Enqueue(Submission submission)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        u64 value = m_NextValue++;
+
+        // Work without waits can join the previous batch as long as that batch
+        // signals nothing but the timeline; the merged batch signals the
+        // highest value, which also satisfies every lower one.
+        if (!m_Pending.empty() && submission.waitSemaphores.empty() && m_Pending.back().signalSemaphores.empty()) {
+            Batch& batch = m_Pending.back();
+            batch.commandBuffers.insert(batch.commandBuffers.end(), submission.commandBuffers.begin(), submission.commandBuffers.end());
+            batch.signalSemaphores = std::move(submission.signalSemaphores);
+            batch.value = value;
+            return value;
+        }
+
+        m_Pending.push_back(Batch {
+            .commandBuffers = std::move(submission.commandBuffers),
+            .waitSemaphores = std::move(submission.waitSemaphores),
+            .signalSemaphores = std::move(submission.signalSemaphores),
+            .value = value
+        });
+
+        return value;
+    }
+
+    u64 VulkanQueueSubmitter::Flush(VkFence fence)
+    {
+        PROFILE_SCOPE("VulkanQueueSubmitter::Flush")
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        std::vector<std::vector<VkCommandBufferSubmitInfo>> commandInfos;
+        std::vector<std::vector<VkSemaphoreSubmitInfo>> signalInfos;
+        std::vector<VkSubmitInfo2> submitInfos;
+        commandInfos.reserve(m_Pending.size());
+        signalInfos.reserve(m_Pending.size());
+        submitInfos.reserve(m_Pending.size());
+
+        for (auto& batch : m_Pending) {
+            auto& commands = commandInfos.emplace_back();
+            commands.reserve(batch.commandBuffers.size());
+            for (const auto& commandBuffer : batch.commandBuffers) {
+                commands.push_back(VkCommandBufferSubmitInfo {
+                    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+                    .pNext = nullptr,
+                    .commandBuffer = commandBuffer,
+                    .deviceMask = 0
+                });
+            }
+
+            auto& signals = signalInfos.emplace_back(batch.signalSemaphores);
+            signals.push_back(SemaphoreInfo(m_Timeline, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, batch.value));
+
+            submitInfos.push_back(VkSubmitInfo2 {
+                .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+                .pNext = nullptr,
+                .flags = 0,
+                .waitSemaphoreInfoCount = static_cast<u32>(batch.waitSemaphores.size()),
+                .pWaitSemaphoreInfos = batch.waitSemaphores.data(),
+                .commandBufferInfoCount = static_cast<u32>(commands.size()),
+                .pCommandBufferInfos = commands.data(),
+                .signalSemaphoreInfoCount = static_cast<u32>(signals.size()),
+                .pSignalSemaphoreInfos = signals.data()
+            });
+        }
+
+        if (!submitInfos.empty() || fence != VK_NULL_HANDLE)
+            VK_CHECK(vkQueueSubmit2(m_Queue.queue, static_cast<u32>(submitInfos.size()), submitInfos.data(), fence));
+
+        if (!m_Pending.empty())
+            m_SubmittedValue = m_Pending.back().value;
+
+        m_Pending.clear();
+        return m_SubmittedValue;
+    }
+
+    u64 VulkanQueueSubmitter::Submit(Submission submission, VkFence fence)
+    {
+        u64 value = Enqueue(std::move(submission));
+        Flush(fence);
+        return value;
+    }
+
+    void VulkanQueueSubmitter::Execute(const std::function<void(VkQueue)>& task)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        task(m_Queue.queue);
+    }
+
+    VkSemaphoreSubmitInfo VulkanQueueSubmitter::WaitInfo(u64 value, VkPipelineStageFlags2 stageMask) const
+    {
+        return SemaphoreInfo(m_Timeline, stageMask, value);
+    }
+
+    VkSemaphoreSubmitInfo VulkanQueueSubmitter::SemaphoreInfo(VkSemaphore semaphore, VkPipelineStageFlags2 stageMask, u64 value)
+    {
+        return VkSemaphoreSubmitInfo {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .pNext = nullptr,
+            .semaphore = semaphore,
+            .value = value,
+            .stageMask = stageMask,
+            .deviceIndex = 0
+        };
+    }
+
+    u64 VulkanQueueSubmitter::GetCompletedValue() const
+    {
+        u64 value = 0;
+        VK_CHECK(vkGetSemaphoreCounterValue(m_Context->GetDevice(), m_Timeline, &value));
+        return value;
+    }
+
+    bool VulkanQueueSubmitter::IsComplete(u64 value) const
+    {
+        return GetCompletedValue() >= value;
+    }
+
+    bool VulkanQueueSubmitter::Wait(u64 value, u64 timeout) const
+    {
+        VkSemaphoreWaitInfo waitInfo {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .semaphoreCount = 1,
+            .pSemaphores = &m_Timeline,
+            .pValues = &value
+        };
+
+        return vkWaitSemaphores(m_Context->GetDevice(), &waitInfo, timeout) == VK_SUCCESS;
+    }
+
+    void VulkanQueueSubmitter::WaitIdle()
+    {
+        u64 value = Flush();
+        Wait(value);
+    }
+
+}
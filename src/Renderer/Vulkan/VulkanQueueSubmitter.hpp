@@ -0,0 +1,64 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "VulkanTypes.hpp"
+#include "VulkanContext.hpp"
+
+namespace Renderer {
+
+    class VulkanQueueSubmitter
+    {
+    public:
+        struct Submission
+        {
+            std::vector<VkCommandBuffer> commandBuffers;
+            std::vector<VkSemaphoreSubmitInfo> waitSemaphores;
+            std::vector<VkSemaphoreSubmitInfo> signalSemaphores;
+        };
+
+    public:
+        VulkanQueueSubmitter(const Ref<VulkanContext>& context, const DeviceQueue& queue);
+        ~VulkanQueueSubmitter();
+
+        inline const DeviceQueue& GetQueue() const { return m_Queue; }
+        inline const VkSemaphore& GetTimeline() const { return m_Timeline; }
+
+        u64 Enqueue(Submission submission);
+        u64 Flush(VkFence fence = VK_NULL_HANDLE);
+        u64 Submit(Submission submission, VkFence fence = VK_NULL_HANDLE);
+
+        void Execute(const std::function<void(VkQueue)>& task);
+
+        VkSemaphoreSubmitInfo WaitInfo(u64 value, VkPipelineStageFlags2 stageMask) const;
+        static VkSemaphoreSubmitInfo SemaphoreInfo(VkSemaphore semaphore, VkPipelineStageFlags2 stageMask, u64 value = 0);
+
+        u64 GetCompletedValue() const;
+        bool IsComplete(u64 value) const;
+        bool Wait(u64 value, u64 timeout = std::numeric_limits<u64>::max()) const;
+        void WaitIdle();
+
+    private:
+        struct Batch
+        {
+            std::vector<VkCommandBuffer> commandBuffers;
+            std::vector<VkSemaphoreSubmitInfo> waitSemaphores;
+            std::vector<VkSemaphoreSubmitInfo> signalSemaphores;
+            u64 value { 0 };
+        };
+
+    private:
+        Ref<VulkanContext> m_Context;
+        DeviceQueue m_Queue;
+
+        VkSemaphore m_Timeline { VK_NULL_HANDLE };
+
+        std::mutex m_Mutex;
+        std::vector<Batch> m_Pending;
+        u64 m_NextValue { 1 };
+        u64 m_SubmittedValue { 0 };
+    };
+
+}
@@ -1,26 +1,24 @@
 #include "VulkanShader.hpp"
 
-#include <fstream>
+#include "Core/Hash.hpp"
+#include "Core/MappedFile.hpp"
 
 namespace Renderer {
 
     VulkanShader::VulkanShader(const Ref<VulkanContext>& context, const std::string& filepath, VkShaderStageFlagBits stage)
         : m_Context(context), m_Stage(stage)
     {
-        std::vector<u8> code = ReadFile(filepath);
+        MappedFile file(filepath);
+        if (!file.IsOpen())
+            return;
 
-        VkShaderModuleCreateInfo createInfo {
-            .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-            .pNext = nullptr,
-            .flags = 0,
-            .codeSize = static_cast<usize>(code.size()),
-            .pCode = reinterpret_cast<const u32*>(code.data())
-        };
+        CreateModule(file.GetBytes(), filepath, std::nullopt);
+    }
 
-        VK_CHECK(vkCreateShaderModule(m_Context->GetDevice(), &createInfo, nullptr, &m_Module));
-        if (m_Module != VK_NULL_HANDLE) {
-            LOG_INFO("Loaded shader file {}", filepath)
-        }
+    VulkanShader::VulkanShader(const Ref<VulkanContext>& context, std::span<const u8> code, VkShaderStageFlagBits stage, const std::string& name, std::optional<u64> hash)
+        : m_Context(context), m_Stage(stage)
+    {
+        CreateModule(code, name, hash);
     }
 
     VulkanShader::~VulkanShader()
@@ -29,25 +27,50 @@ namespace Renderer {
             vkDestroyShaderModule(m_Context->GetDevice(), m_Module, nullptr);
     }
 
-    std::vector<u8> VulkanShader::ReadFile(const std::string& filepath)
+    u64 VulkanShader::Hash(std::span<const u8> code)
     {
-        std::vector<u8> data;
+        return HashBytes(code);
+    }
 
-        std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    void VulkanShader::CreateModule(std::span<const u8> code, const std::string& name, std::optional<u64> hash)
+    {
+        (void)name;
 
-        if (!file.is_open()) {
-            LOG_ERROR("Failed to open file {}", filepath)
-            return data;
+        if (code.size() % sizeof(u32) != 0 || reinterpret_cast<uintptr_t>(code.data()) % alignof(u32) != 0) {
+            LOG_ERROR("Invalid SPIR-V code in {}", name)
+            return;
         }
 
-        data.resize(static_cast<usize>(file.tellg()));
-        file.seekg(0, std::ios::beg);
+        m_Hash = hash.has_value() ? hash.value() : Hash(code);
+        m_CodeSize = code.size();
 
-        file.read(reinterpret_cast<char*>(data.data()), data.size());
+        if (auto reflection = ShaderReflection::Reflect(code)) {
+            m_Reflection = std::move(reflection.value());
+        } else {
+            m_Reflection.stages = m_Stage;
+        }
 
-        file.close();
+        // The code is passed straight from the mapping; the driver copies it
+        // during module creation.
+        VkShaderModuleCreateInfo createInfo {
+            .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .codeSize = code.size(),
+            .pCode = reinterpret_cast<const u32*>(code.data())
+        };
+
+        VK_CHECK(vkCreateShaderModule(m_Context->GetDevice(), &createInfo, nullptr, &m_Module));
+        if (m_Module != VK_NULL_HANDLE) {
+            LOG_INFO("Loaded shader {}", name)
+        }
 
-        return data;
+        // Shader objects are created from the code rather than the module, and
+        // the mapping does not outlive this call.
+        if (m_Context->SupportsShaderObject()) {
+            const u32* words = reinterpret_cast<const u32*>(code.data());
+            m_Code.assign(words, words + code.size() / sizeof(u32));
+        }
     }
 
 }
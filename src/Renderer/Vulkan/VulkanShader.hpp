@@ -1,9 +1,13 @@
 #pragma once
 
+#include <optional>
+#include <span>
 #include <string>
+#include <vector>
 
 #include "VulkanTypes.hpp"
 #include "VulkanContext.hpp"
+#include "VulkanShaderReflection.hpp"
 
 namespace Renderer {
 
@@ -11,19 +15,30 @@ namespace Renderer {
     {
     public:
         VulkanShader(const Ref<VulkanContext>& context, const std::string& filepath, VkShaderStageFlagBits stage);
+        VulkanShader(const Ref<VulkanContext>& context, std::span<const u8> code, VkShaderStageFlagBits stage, const std::string& name, std::optional<u64> hash = std::nullopt);
         ~VulkanShader();
 
         inline const VkShaderModule& GetModule() const { return m_Module; }
         inline const VkShaderStageFlagBits& GetStage() const { return m_Stage; }
+        inline u64 GetHash() const { return m_Hash; }
+        inline usize GetCodeSize() const { return m_CodeSize; }
+        inline std::span<const u32> GetCode() const { return m_Code; }
+        inline const ShaderReflection& GetReflection() const { return m_Reflection; }
+
+        static u64 Hash(std::span<const u8> code);
 
     private:
-        static std::vector<u8> ReadFile(const std::string& filepath);
+        void CreateModule(std::span<const u8> code, const std::string& name, std::optional<u64> hash);
 
     private:
         Ref<VulkanContext> m_Context;
 
         VkShaderModule m_Module { VK_NULL_HANDLE };
         VkShaderStageFlagBits m_Stage { VK_SHADER_STAGE_ALL };
+        u64 m_Hash { 0 };
+        usize m_CodeSize { 0 };
+        std::vector<u32> m_Code;
+        ShaderReflection m_Reflection;
     };
 
 }
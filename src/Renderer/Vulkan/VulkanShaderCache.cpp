@@ -0,0 +1,85 @@
+#include "VulkanShaderCache.hpp"
+
+#include "Core/MappedFile.hpp"
+
+namespace Renderer {
+
+    VulkanShaderCache::VulkanShaderCache(const Ref<VulkanContext>& context)
+        : m_Context(context)
+    {
+    }
+
+    Ref<VulkanShader> VulkanShaderCache::Load(const std::string& filepath, VkShaderStageFlagBits stage)
+    {
+        MappedFile file(filepath);
+        if (!file.IsOpen())
+            return nullptr;
+
+        return Get(file.GetBytes(), stage, filepath);
+    }
+
+    Ref<VulkanShader> VulkanShaderCache::Load(const ShaderArchive& archive, const std::string& name, VkShaderStageFlagBits stage)
+    {
+        auto blob = archive.Find(name);
+        if (!blob.has_value()) {
+            LOG_ERROR("Shader {} not found in {}", name, archive.GetPath())
+            return nullptr;
+        }
+
+        // The archive stores content hashes, so the code is not hashed again.
+        return Get(blob->data, blob->hash, stage, name);
+    }
+
+    Ref<VulkanShader> VulkanShaderCache::Get(std::span<const u8> code, VkShaderStageFlagBits stage, const std::string& name)
+    {
+        return Get(code, VulkanShader::Hash(code), stage, name);
+    }
+
+    Ref<VulkanShader> VulkanShaderCache::Get(std::span<const u8> code, u64 hash, VkShaderStageFlagBits stage, const std::string& name)
+    {
+        u64 key = MakeKey(hash, stage);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_Shaders.find(key);
+        if (it != m_Shaders.end() && it->second->GetCodeSize() == code.size()) {
+            ++m_Stats.hits;
+            return it->second;
+        }
+
+        ++m_Stats.misses;
+
+        auto shader = CreateRef<VulkanShader>(m_Context, code, stage, name, hash);
+        if (shader->GetModule() == VK_NULL_HANDLE)
+            return nullptr;
+
+        m_Shaders[key] = shader;
+        return shader;
+    }
+
+    usize VulkanShaderCache::Trim()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return std::erase_if(m_Shaders, [](const auto& entry) {
+            return entry.second.use_count() == 1;
+        });
+    }
+
+    void VulkanShaderCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Shaders.clear();
+    }
+
+    VulkanShaderCache::Stats VulkanShaderCache::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Stats;
+    }
+
+    u64 VulkanShaderCache::MakeKey(u64 hash, VkShaderStageFlagBits stage)
+    {
+        return hash ^ (static_cast<u64>(stage) * 0x9E3779B97F4A7C15ull);
+    }
+
+}
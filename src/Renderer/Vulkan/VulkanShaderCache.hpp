@@ -0,0 +1,48 @@
+#pragma once
+
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+#include "Core/ShaderArchive.hpp"
+#include "VulkanTypes.hpp"
+#include "VulkanContext.hpp"
+#include "VulkanShader.hpp"
+
+namespace Renderer {
+
+    class VulkanShaderCache
+    {
+    public:
+        struct Stats
+        {
+            u64 hits { 0 };
+            u64 misses { 0 };
+        };
+
+    public:
+        VulkanShaderCache(const Ref<VulkanContext>& context);
+
+        Ref<VulkanShader> Load(const std::string& filepath, VkShaderStageFlagBits stage);
+        Ref<VulkanShader> Load(const ShaderArchive& archive, const std::string& name, VkShaderStageFlagBits stage);
+        Ref<VulkanShader> Get(std::span<const u8> code, VkShaderStageFlagBits stage, const std::string& name);
+        Ref<VulkanShader> Get(std::span<const u8> code, u64 hash, VkShaderStageFlagBits stage, const std::string& name);
+
+        usize Trim();
+        void Clear();
+
+        Stats GetStats() const;
+
+    private:
+        static u64 MakeKey(u64 hash, VkShaderStageFlagBits stage);
+
+    private:
+        Ref<VulkanContext> m_Context;
+
+        mutable std::mutex m_Mutex;
+        std::unordered_map<u64, Ref<VulkanShader>> m_Shaders;
+        Stats m_Stats;
+    };
+
+}
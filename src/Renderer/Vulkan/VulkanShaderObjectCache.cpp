@@ -0,0 +1,66 @@
+#include "VulkanShaderObjectCache.hpp"
+
+#include "Core/Profiler.hpp"
+
+namespace Renderer {
+
+    VulkanShaderObjectCache::VulkanShaderObjectCache(const Ref<VulkanContext>& context, VulkanLayoutCache& layoutCache)
+        : m_Context(context), m_LayoutCache(layoutCache)
+    {
+    }
+
+    bool VulkanShaderObjectCache::Contains(const VulkanGraphicsPipeline::Config& cfg) const
+    {
+        ShaderReflection reflection = VulkanGraphicsPipeline::Reflect(cfg);
+        VkPipelineLayout layout = VulkanGraphicsPipeline::ResolveLayout(cfg, reflection, m_LayoutCache);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_ShaderObjects.contains(MakeKey(cfg, layout));
+    }
+
+    Ref<VulkanGraphicsPipeline> VulkanShaderObjectCache::Create(const VulkanGraphicsPipeline::Config& cfg)
+    {
+        PROFILE_SCOPE("VulkanShaderObjectCache::Create")
+
+        ShaderReflection reflection = VulkanGraphicsPipeline::Reflect(cfg);
+        VkPipelineLayout layout = VulkanGraphicsPipeline::ResolveLayout(cfg, reflection, m_LayoutCache);
+        Key key = MakeKey(cfg, layout);
+
+        Ref<VulkanShaderObjects> shaderObjects;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (auto it = m_ShaderObjects.find(key); it != m_ShaderObjects.end())
+                shaderObjects = it->second;
+        }
+
+        // Compiled outside the lock like pipeline libraries; a racing
+        // duplicate is dropped in favour of the one already cached.
+        if (!shaderObjects) {
+            shaderObjects = VulkanGraphicsPipeline::CreateShaderObjects(m_Context, cfg, reflection, m_LayoutCache);
+
+            if (shaderObjects->IsValid()) {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                shaderObjects = m_ShaderObjects.emplace(std::move(key), shaderObjects).first->second;
+            }
+        }
+
+        return CreateRef<VulkanGraphicsPipeline>(m_Context, cfg, layout, shaderObjects);
+    }
+
+    VulkanShaderObjectCache::Key VulkanShaderObjectCache::MakeKey(const VulkanGraphicsPipeline::Config& cfg, VkPipelineLayout layout)
+    {
+        // Only the code and its interface are compiled into shader objects;
+        // every other part of the config is set when binding.
+        Key key { VulkanLayoutCache::HandleKey(layout) };
+
+        for (const auto& shader : cfg.shaders) {
+            key.push_back(static_cast<u64>(shader->GetStage()));
+            key.push_back(shader->GetHash());
+            if (auto it = cfg.specialization.find(shader->GetStage()); it != cfg.specialization.end())
+                it->second.AppendKey(key);
+        }
+
+        return key;
+    }
+
+}
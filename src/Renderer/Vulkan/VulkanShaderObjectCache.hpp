@@ -0,0 +1,36 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "VulkanTypes.hpp"
+#include "VulkanContext.hpp"
+#include "VulkanGraphicsPipeline.hpp"
+#include "VulkanLayoutCache.hpp"
+#include "VulkanShaderObjects.hpp"
+
+namespace Renderer {
+
+    class VulkanShaderObjectCache
+    {
+    public:
+        VulkanShaderObjectCache(const Ref<VulkanContext>& context, VulkanLayoutCache& layoutCache);
+
+        bool Contains(const VulkanGraphicsPipeline::Config& cfg) const;
+        Ref<VulkanGraphicsPipeline> Create(const VulkanGraphicsPipeline::Config& cfg);
+
+    private:
+        using Key = std::vector<u64>;
+
+        static Key MakeKey(const VulkanGraphicsPipeline::Config& cfg, VkPipelineLayout layout);
+
+    private:
+        Ref<VulkanContext> m_Context;
+        VulkanLayoutCache& m_LayoutCache;
+
+        mutable std::mutex m_Mutex;
+        std::map<Key, Ref<VulkanShaderObjects>> m_ShaderObjects;
+    };
+
+}
@@ -0,0 +1,109 @@
+#include "VulkanShaderObjects.hpp"
+
+#include <algorithm>
+
+#include "Core/Profiler.hpp"
+
+namespace Renderer {
+
+    VulkanShaderObjects::VulkanShaderObjects(
+        const Ref<VulkanContext>& context,
+        std::span<const Ref<VulkanShader>> shaders,
+        const std::map<VkShaderStageFlagBits, VulkanSpecializationConstants>& specialization,
+        std::span<const VkDescriptorSetLayout> setLayouts,
+        std::span<const VkPushConstantRange> pushConstantRanges
+    )
+        : m_Context(context),
+          m_Stages { VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT },
+          m_Shaders(m_Stages.size(), VK_NULL_HANDLE)
+    {
+        PROFILE_SCOPE("VulkanShaderObjects::Create")
+
+        VkShaderStageFlags presentStages = 0;
+        for (const auto& shader : shaders)
+            presentStages |= shader->GetStage();
+
+        std::vector<VkSpecializationInfo> specializationInfos;
+        specializationInfos.reserve(shaders.size());
+
+        std::vector<VkShaderCreateInfoEXT> createInfos;
+        createInfos.reserve(shaders.size());
+        for (const auto& shader : shaders) {
+            if (shader->GetCode().empty()) {
+                LOG_ERROR("Shader objects need the SPIR-V of every stage")
+                return;
+            }
+
+            const VkSpecializationInfo* specializationInfo = nullptr;
+            if (auto it = specialization.find(shader->GetStage()); it != specialization.end() && !it->second.IsEmpty())
+                specializationInfo = &specializationInfos.emplace_back(it->second.GetInfo());
+
+            // Linked stages are compiled together, which lets the driver
+            // optimize across the interface like a monolithic pipeline.
+            createInfos.push_back(VkShaderCreateInfoEXT {
+                .sType = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT,
+                .pNext = nullptr,
+                .flags = shaders.size() > 1 ? VkShaderCreateFlagsEXT(VK_SHADER_CREATE_LINK_STAGE_BIT_EXT) : 0,
+                .stage = shader->GetStage(),
+                .nextStage = GetNextStages(shader->GetStage()) & presentStages,
+                .codeType = VK_SHADER_CODE_TYPE_SPIRV_EXT,
+                .codeSize = shader->GetCode().size_bytes(),
+                .pCode = shader->GetCode().data(),
+                .pName = shader->GetReflection().entryPoint.c_str(),
+                .setLayoutCount = static_cast<u32>(setLayouts.size()),
+                .pSetLayouts = setLayouts.data(),
+                .pushConstantRangeCount = static_cast<u32>(pushConstantRanges.size()),
+                .pPushConstantRanges = pushConstantRanges.data(),
+                .pSpecializationInfo = specializationInfo
+            });
+        }
+
+        std::vector<VkShaderEXT> created(createInfos.size(), VK_NULL_HANDLE);
+        VK_CHECK(vkCreateShadersEXT(m_Context->GetDevice(), static_cast<u32>(createInfos.size()), createInfos.data(), nullptr, created.data()));
+
+        // Vertex and fragment are always bound, so a set without a fragment
+        // shader unbinds the one left by a previous set.
+        for (usize i = 0; i < createInfos.size(); ++i) {
+            auto it = std::find(m_Stages.begin(), m_Stages.end(), createInfos[i].stage);
+            if (it != m_Stages.end()) {
+                m_Shaders[static_cast<usize>(it - m_Stages.begin())] = created[i];
+            } else {
+                m_Stages.push_back(createInfos[i].stage);
+                m_Shaders.push_back(created[i]);
+            }
+        }
+
+        m_Valid = m_Shaders[0] != VK_NULL_HANDLE
+            && std::none_of(created.begin(), created.end(), [](VkShaderEXT shader) { return shader == VK_NULL_HANDLE; });
+    }
+
+    VulkanShaderObjects::~VulkanShaderObjects()
+    {
+        for (VkShaderEXT shader : m_Shaders) {
+            if (shader != VK_NULL_HANDLE)
+                vkDestroyShaderEXT(m_Context->GetDevice(), shader, nullptr);
+        }
+    }
+
+    void VulkanShaderObjects::Bind(const VkCommandBuffer& cmd) const
+    {
+        vkCmdBindShadersEXT(cmd, static_cast<u32>(m_Stages.size()), m_Stages.data(), m_Shaders.data());
+    }
+
+    VkShaderStageFlags VulkanShaderObjects::GetNextStages(VkShaderStageFlagBits stage)
+    {
+        switch (stage) {
+            case VK_SHADER_STAGE_VERTEX_BIT:
+                return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT | VK_SHADER_STAGE_GEOMETRY_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+            case VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT:
+                return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+            case VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT:
+                return VK_SHADER_STAGE_GEOMETRY_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+            case VK_SHADER_STAGE_GEOMETRY_BIT:
+                return VK_SHADER_STAGE_FRAGMENT_BIT;
+            default:
+                return 0;
+        }
+    }
+
+}
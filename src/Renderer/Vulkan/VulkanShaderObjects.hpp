@@ -0,0 +1,41 @@
+#pragma once
+
+#include <map>
+#include <span>
+#include <vector>
+
+#include "VulkanTypes.hpp"
+#include "VulkanContext.hpp"
+#include "VulkanShader.hpp"
+#include "VulkanSpecializationConstants.hpp"
+
+namespace Renderer {
+
+    class VulkanShaderObjects
+    {
+    public:
+        VulkanShaderObjects(
+            const Ref<VulkanContext>& context,
+            std::span<const Ref<VulkanShader>> shaders,
+            const std::map<VkShaderStageFlagBits, VulkanSpecializationConstants>& specialization,
+            std::span<const VkDescriptorSetLayout> setLayouts,
+            std::span<const VkPushConstantRange> pushConstantRanges
+        );
+        ~VulkanShaderObjects();
+
+        inline bool IsValid() const { return m_Valid; }
+
+        void Bind(const VkCommandBuffer& cmd) const;
+
+    private:
+        static VkShaderStageFlags GetNextStages(VkShaderStageFlagBits stage);
+
+    private:
+        Ref<VulkanContext> m_Context;
+
+        std::vector<VkShaderStageFlagBits> m_Stages;
+        std::vector<VkShaderEXT> m_Shaders;
+        bool m_Valid { false };
+    };
+
+}
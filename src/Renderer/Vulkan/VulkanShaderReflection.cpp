@@ -0,0 +1,516 @@
+#include "VulkanShaderReflection.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace Renderer {
+
+    namespace {
+
+        enum Op : u32
+        {
+            OpEntryPoint = 15,
+            OpExecutionMode = 16,
+            OpTypeBool = 20,
+            OpTypeInt = 21,
+            OpTypeFloat = 22,
+            OpTypeVector = 23,
+            OpTypeMatrix = 24,
+            OpTypeImage = 25,
+            OpTypeSampler = 26,
+            OpTypeSampledImage = 27,
+            OpTypeArray = 28,
+            OpTypeRuntimeArray = 29,
+            OpTypeStruct = 30,
+            OpTypePointer = 32,
+            OpConstant = 43,
+            OpSpecConstantTrue = 48,
+            OpSpecConstantFalse = 49,
+            OpSpecConstant = 50,
+            OpVariable = 59,
+            OpDecorate = 71,
+            OpMemberDecorate = 72,
+            OpTypeAccelerationStructure = 5341
+        };
+
+        enum Decoration : u32
+        {
+            SpecId = 1,
+            Block = 2,
+            BufferBlock = 3,
+            ArrayStride = 6,
+            MatrixStride = 7,
+            BuiltIn = 11,
+            Location = 30,
+            Binding = 33,
+            DescriptorSet = 34,
+            Offset = 35
+        };
+
+        enum StorageClass : u32
+        {
+            UniformConstant = 0,
+            Input = 1,
+            Uniform = 2,
+            PushConstant = 9,
+            StorageBuffer = 12
+        };
+
+        struct Type
+        {
+            u32 opcode { 0 };
+            std::vector<u32> operands;
+        };
+
+        struct Decorations
+        {
+            std::optional<u32> specId;
+            std::optional<u32> arrayStride;
+            std::optional<u32> location;
+            std::optional<u32> binding;
+            std::optional<u32> set;
+            bool block { false };
+            bool bufferBlock { false };
+            bool builtIn { false };
+            std::unordered_map<u32, u32> memberOffsets;
+            std::unordered_map<u32, u32> memberMatrixStrides;
+        };
+
+        struct Variable
+        {
+            u32 type { 0 };
+            u32 storage { 0 };
+        };
+
+        struct Module
+        {
+            std::unordered_map<u32, Type> types;
+            std::unordered_map<u32, u32> constants;
+            std::unordered_map<u32, Decorations> decorations;
+            std::unordered_map<u32, Variable> variables;
+            std::vector<std::pair<u32, u32>> specConstants;
+
+            const Type* Find(u32 id) const
+            {
+                auto it = types.find(id);
+                return it != types.end() ? &it->second : nullptr;
+            }
+
+            const Decorations* FindDecorations(u32 id) const
+            {
+                auto it = decorations.find(id);
+                return it != decorations.end() ? &it->second : nullptr;
+            }
+
+            u32 GetSize(u32 id, u32 matrixStride = 0) const
+            {
+                const Type* type = Find(id);
+                if (!type)
+                    return 0;
+
+                switch (type->opcode) {
+                    case OpTypeBool:
+                        return 4;
+                    case OpTypeInt:
+                    case OpTypeFloat:
+                        return type->operands.at(0) / 8;
+                    case OpTypeVector:
+                        return GetSize(type->operands.at(0)) * type->operands.at(1);
+                    case OpTypeMatrix:
+                        return (matrixStride != 0 ? matrixStride : GetSize(type->operands.at(0))) * type->operands.at(1);
+                    case OpTypeArray: {
+                        auto length = constants.find(type->operands.at(1));
+                        const Decorations* decorated = FindDecorations(id);
+                        u32 stride = decorated && decorated->arrayStride ? *decorated->arrayStride : GetSize(type->operands.at(0));
+                        return length != constants.end() ? stride * length->second : 0;
+                    }
+                    case OpTypeStruct: {
+                        const Decorations* decorated = FindDecorations(id);
+                        u32 size = 0;
+                        for (u32 member = 0; member < type->operands.size(); ++member) {
+                            u32 offset = 0;
+                            u32 stride = 0;
+                            if (decorated) {
+                                if (auto it = decorated->memberOffsets.find(member); it != decorated->memberOffsets.end())
+                                    offset = it->second;
+                                if (auto it = decorated->memberMatrixStrides.find(member); it != decorated->memberMatrixStrides.end())
+                                    stride = it->second;
+                            }
+                            size = std::max(size, offset + GetSize(type->operands[member], stride));
+                        }
+                        return size;
+                    }
+                    default:
+                        return 0;
+                }
+            }
+        };
+
+        VkShaderStageFlags ToStage(u32 executionModel)
+        {
+            switch (executionModel) {
+                case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+                case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+                case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+                case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+                case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+                case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+                case 5364: return VK_SHADER_STAGE_TASK_BIT_EXT;
+                case 5365: return VK_SHADER_STAGE_MESH_BIT_EXT;
+                default: return 0;
+            }
+        }
+
+        VkFormat ToVertexFormat(const Module& module, u32 typeId)
+        {
+            const Type* type = module.Find(typeId);
+            if (!type)
+                return VK_FORMAT_UNDEFINED;
+
+            u32 components = 1;
+            if (type->opcode == OpTypeVector) {
+                components = type->operands.at(1);
+                type = module.Find(type->operands.at(0));
+                if (!type)
+                    return VK_FORMAT_UNDEFINED;
+            }
+
+            if ((type->opcode != OpTypeFloat && type->opcode != OpTypeInt) || type->operands.at(0) != 32)
+                return VK_FORMAT_UNDEFINED;
+
+            static constexpr std::array<VkFormat, 4> floats { VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT };
+            static constexpr std::array<VkFormat, 4> sints { VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT };
+            static constexpr std::array<VkFormat, 4> uints { VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT };
+
+            if (components < 1 || components > 4)
+                return VK_FORMAT_UNDEFINED;
+
+            if (type->opcode == OpTypeFloat)
+                return floats[components - 1];
+            if (type->opcode == OpTypeInt)
+                return type->operands.at(1) ? sints[components - 1] : uints[components - 1];
+
+            return VK_FORMAT_UNDEFINED;
+        }
+
+        std::optional<VkDescriptorType> ToDescriptorType(const Module& module, u32 typeId, u32 storage)
+        {
+            const Type* type = module.Find(typeId);
+            if (!type)
+                return std::nullopt;
+
+            if (storage == StorageBuffer)
+                return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+
+            if (storage == Uniform) {
+                const Decorations* decorated = module.FindDecorations(typeId);
+                if (decorated && decorated->bufferBlock)
+                    return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            }
+
+            switch (type->opcode) {
+                case OpTypeSampler:
+                    return VK_DESCRIPTOR_TYPE_SAMPLER;
+                case OpTypeSampledImage:
+                    return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                case OpTypeAccelerationStructure:
+                    return VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+                case OpTypeImage: {
+                    static constexpr u32 dimBuffer = 5;
+                    static constexpr u32 dimSubpassData = 6;
+                    u32 dim = type->operands.at(1);
+                    u32 sampled = type->operands.at(5);
+                    if (dim == dimSubpassData)
+                        return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                    if (dim == dimBuffer)
+                        return sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                    return sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                }
+                default:
+                    return std::nullopt;
+            }
+        }
+
+    }
+
+    std::optional<ShaderReflection> ShaderReflection::Reflect(std::span<const u8> code)
+    {
+        static constexpr u32 magic = 0x07230203;
+        static constexpr usize headerWords = 5;
+
+        std::vector<u32> words(code.size() / sizeof(u32));
+        std::memcpy(words.data(), code.data(), words.size() * sizeof(u32));
+
+        if (words.size() < headerWords || words[0] != magic) {
+            LOG_ERROR("Cannot reflect shader: not a SPIR-V module")
+            return std::nullopt;
+        }
+
+        ShaderReflection reflection;
+        Module module;
+        bool hasEntryPoint = false;
+
+        for (usize i = headerWords; i < words.size();) {
+            u32 wordCount = words[i] >> 16;
+            u32 opcode = words[i] & 0xFFFF;
+            if (wordCount == 0 || i + wordCount > words.size()) {
+                LOG_ERROR("Cannot reflect shader: malformed instruction stream")
+                return std::nullopt;
+            }
+
+            std::span<const u32> operands { words.data() + i + 1, wordCount - 1 };
+            i += wordCount;
+
+            switch (opcode) {
+                case OpEntryPoint: {
+                    // Only the first entry point is reflected; the pipelines
+                    // here always use one entry point per module.
+                    if (hasEntryPoint || operands.size() < 3)
+                        break;
+                    hasEntryPoint = true;
+                    reflection.stages = ToStage(operands[0]);
+                    const char* name = reinterpret_cast<const char*>(operands.data() + 2);
+                    reflection.entryPoint.assign(name, strnlen(name, (operands.size() - 2) * sizeof(u32)));
+                    break;
+                }
+                case OpExecutionMode: {
+                    static constexpr u32 localSizeMode = 17;
+                    if (operands.size() >= 5 && operands[1] == localSizeMode)
+                        reflection.localSize = { operands[2], operands[3], operands[4] };
+                    break;
+                }
+                case OpTypeBool:
+                case OpTypeInt:
+                case OpTypeFloat:
+                case OpTypeVector:
+                case OpTypeMatrix:
+                case OpTypeImage:
+                case OpTypeSampler:
+                case OpTypeSampledImage:
+                case OpTypeArray:
+                case OpTypeRuntimeArray:
+                case OpTypeStruct:
+                case OpTypePointer:
+                case OpTypeAccelerationStructure: {
+                    if (operands.empty())
+                        break;
+                    module.types[operands[0]] = Type { .opcode = opcode, .operands = { operands.begin() + 1, operands.end() } };
+                    break;
+                }
+                case OpConstant: {
+                    if (operands.size() >= 3)
+                        module.constants[operands[1]] = operands[2];
+                    break;
+                }
+                case OpSpecConstantTrue:
+                case OpSpecConstantFalse:
+                case OpSpecConstant: {
+                    if (operands.size() >= 2)
+                        module.specConstants.emplace_back(operands[1], operands[0]);
+                    if (opcode == OpSpecConstant && operands.size() >= 3)
+                        module.constants[operands[1]] = operands[2];
+                    break;
+                }
+                case OpVariable: {
+                    if (operands.size() >= 3)
+                        module.variables[operands[1]] = Variable { .type = operands[0], .storage = operands[2] };
+                    break;
+                }
+                case OpDecorate: {
+                    if (operands.size() < 2)
+                        break;
+                    Decorations& decorated = module.decorations[operands[0]];
+                    std::optional<u32> literal = operands.size() >= 3 ? std::optional<u32>(operands[2]) : std::nullopt;
+                    switch (operands[1]) {
+                        case SpecId: decorated.specId = literal; break;
+                        case Block: decorated.block = true; break;
+                        case BufferBlock: decorated.bufferBlock = true; break;
+                        case ArrayStride: decorated.arrayStride = literal; break;
+                        case BuiltIn: decorated.builtIn = true; break;
+                        case Location: decorated.location = literal; break;
+                        case Binding: decorated.binding = literal; break;
+                        case DescriptorSet: decorated.set = literal; break;
+                        default: break;
+                    }
+                    break;
+                }
+                case OpMemberDecorate: {
+                    if (operands.size() < 4)
+                        break;
+                    Decorations& decorated = module.decorations[operands[0]];
+                    if (operands[2] == Offset)
+                        decorated.memberOffsets[operands[1]] = operands[3];
+                    else if (operands[2] == MatrixStride)
+                        decorated.memberMatrixStrides[operands[1]] = operands[3];
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        if (!hasEntryPoint) {
+            LOG_ERROR("Cannot reflect shader: no entry point")
+            return std::nullopt;
+        }
+
+        for (const auto& [id, variable] : module.variables) {
+            const Type* pointer = module.Find(variable.type);
+            if (!pointer || pointer->opcode != OpTypePointer)
+                continue;
+
+            u32 typeId = pointer->operands.at(1);
+            const Decorations* decorated = module.FindDecorations(id);
+
+            if (variable.storage == PushConstant) {
+                const Decorations* block = module.FindDecorations(typeId);
+                u32 begin = std::numeric_limits<u32>::max();
+                if (block) {
+                    for (const auto& [_, offset] : block->memberOffsets)
+                        begin = std::min(begin, offset);
+                }
+                if (begin == std::numeric_limits<u32>::max())
+                    begin = 0;
+
+                reflection.pushConstants = VkPushConstantRange {
+                    .stageFlags = reflection.stages,
+                    .offset = begin,
+                    .size = module.GetSize(typeId) - begin
+                };
+                continue;
+            }
+
+            if (variable.storage == Input) {
+                if (reflection.stages != VK_SHADER_STAGE_VERTEX_BIT || !decorated || !decorated->location || decorated->builtIn)
+                    continue;
+
+                VkFormat format = ToVertexFormat(module, typeId);
+                if (format == VK_FORMAT_UNDEFINED) {
+                    LOG_WARN("Vertex input at location {} has an unsupported type", *decorated->location)
+                    continue;
+                }
+
+                reflection.vertexInputs.push_back(VertexInput {
+                    .location = *decorated->location,
+                    .format = format,
+                    .size = module.GetSize(typeId)
+                });
+                continue;
+            }
+
+            if (variable.storage != UniformConstant && variable.storage != Uniform && variable.storage != StorageBuffer)
+                continue;
+            if (!decorated || !decorated->binding)
+                continue;
+
+            u32 count = 1;
+            const Type* type = module.Find(typeId);
+            while (type && (type->opcode == OpTypeArray || type->opcode == OpTypeRuntimeArray)) {
+                if (type->opcode == OpTypeArray) {
+                    auto length = module.constants.find(type->operands.at(1));
+                    count *= length != module.constants.end() ? length->second : 1;
+                }
+                typeId = type->operands.at(0);
+                type = module.Find(typeId);
+            }
+
+            auto descriptorType = ToDescriptorType(module, typeId, variable.storage);
+            if (!descriptorType.has_value())
+                continue;
+
+            reflection.bindings.push_back(DescriptorBinding {
+                .set = decorated->set.value_or(0),
+                .binding = *decorated->binding,
+                .type = *descriptorType,
+                .count = count,
+                .stages = reflection.stages
+            });
+        }
+
+        for (const auto& [id, typeId] : module.specConstants) {
+            const Decorations* decorated = module.FindDecorations(id);
+            if (!decorated || !decorated->specId)
+                continue;
+
+            reflection.specializationConstants.push_back(SpecializationConstant {
+                .id = *decorated->specId,
+                .size = module.GetSize(typeId)
+            });
+        }
+
+        std::sort(reflection.bindings.begin(), reflection.bindings.end(), [](const DescriptorBinding& a, const DescriptorBinding& b) {
+            return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+        });
+        std::sort(reflection.vertexInputs.begin(), reflection.vertexInputs.end(), [](const VertexInput& a, const VertexInput& b) {
+            return a.location < b.location;
+        });
+        std::sort(reflection.specializationConstants.begin(), reflection.specializationConstants.end(), [](const SpecializationConstant& a, const SpecializationConstant& b) {
+            return a.id < b.id;
+        });
+
+        return reflection;
+    }
+
+    void ShaderReflection::Merge(const ShaderReflection& other)
+    {
+        stages |= other.stages;
+
+        for (const auto& binding : other.bindings) {
+            auto it = std::find_if(bindings.begin(), bindings.end(), [&](const DescriptorBinding& existing) {
+                return existing.set == binding.set && existing.binding == binding.binding;
+            });
+
+            if (it == bindings.end()) {
+                bindings.push_back(binding);
+                continue;
+            }
+
+            if (it->type != binding.type) {
+                LOG_ERROR("Descriptor set {} binding {} is declared with different types across stages", binding.set, binding.binding)
+            }
+            it->stages |= binding.stages;
+            it->count = std::max(it->count, binding.count);
+        }
+
+        std::sort(bindings.begin(), bindings.end(), [](const DescriptorBinding& a, const DescriptorBinding& b) {
+            return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+        });
+
+        // Stages share one push constant range covering every block.
+        if (other.pushConstants.has_value()) {
+            if (!pushConstants.has_value()) {
+                pushConstants = other.pushConstants;
+            } else {
+                u32 begin = std::min(pushConstants->offset, other.pushConstants->offset);
+                u32 end = std::max(pushConstants->offset + pushConstants->size, other.pushConstants->offset + other.pushConstants->size);
+                pushConstants = VkPushConstantRange {
+                    .stageFlags = pushConstants->stageFlags | other.pushConstants->stageFlags,
+                    .offset = begin,
+                    .size = end - begin
+                };
+            }
+        }
+
+        if (other.stages & VK_SHADER_STAGE_VERTEX_BIT)
+            vertexInputs = other.vertexInputs;
+
+        for (const auto& constant : other.specializationConstants) {
+            bool known = std::any_of(specializationConstants.begin(), specializationConstants.end(), [&](const SpecializationConstant& existing) {
+                return existing.id == constant.id;
+            });
+            if (!known)
+                specializationConstants.push_back(constant);
+        }
+    }
+
+    u32 ShaderReflection::GetSetCount() const
+    {
+        u32 count = 0;
+        for (const auto& binding : bindings)
+            count = std::max(count, binding.set + 1);
+        return count;
+    }
+
+}
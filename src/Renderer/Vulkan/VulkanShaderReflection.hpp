@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "VulkanTypes.hpp"
+
+namespace Renderer {
+
+    struct ShaderReflection
+    {
+        struct DescriptorBinding
+        {
+            u32 set { 0 };
+            u32 binding { 0 };
+            VkDescriptorType type { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER };
+            u32 count { 1 };
+            VkShaderStageFlags stages { 0 };
+        };
+
+        struct VertexInput
+        {
+            u32 location { 0 };
+            VkFormat format { VK_FORMAT_UNDEFINED };
+            u32 size { 0 };
+        };
+
+        struct SpecializationConstant
+        {
+            u32 id { 0 };
+            u32 size { 0 };
+        };
+
+        VkShaderStageFlags stages { 0 };
+        std::string entryPoint { "main" };
+        std::array<u32, 3> localSize { 1, 1, 1 };
+
+        std::vector<DescriptorBinding> bindings;
+        std::optional<VkPushConstantRange> pushConstants;
+        std::vector<VertexInput> vertexInputs;
+        std::vector<SpecializationConstant> specializationConstants;
+
+        static std::optional<ShaderReflection> Reflect(std::span<const u8> code);
+
+        void Merge(const ShaderReflection& other);
+        u32 GetSetCount() const;
+    };
+
+}
@@ -0,0 +1,90 @@
+#include "VulkanSpecializationConstants.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Renderer {
+
+    VulkanSpecializationConstants& VulkanSpecializationConstants::SetBytes(u32 id, const void* data, usize size)
+    {
+        auto it = std::find_if(m_Entries.begin(), m_Entries.end(), [id](const VkSpecializationMapEntry& entry) {
+            return entry.constantID == id;
+        });
+
+        if (it != m_Entries.end() && it->size == size) {
+            std::memcpy(m_Data.data() + it->offset, data, size);
+            return *this;
+        }
+
+        // A constant changing size is rare enough to just drop its old bytes
+        // and append at the end.
+        if (it != m_Entries.end()) {
+            u32 offset = it->offset;
+            usize oldSize = it->size;
+            m_Data.erase(m_Data.begin() + offset, m_Data.begin() + static_cast<std::ptrdiff_t>(offset + oldSize));
+            m_Entries.erase(it);
+
+            for (auto& entry : m_Entries) {
+                if (entry.offset > offset)
+                    entry.offset -= static_cast<u32>(oldSize);
+            }
+        }
+
+        // Entries stay sorted by id so that equal sets compare and key equal
+        // regardless of the order they were set in.
+        auto position = std::lower_bound(m_Entries.begin(), m_Entries.end(), id, [](const VkSpecializationMapEntry& entry, u32 value) {
+            return entry.constantID < value;
+        });
+
+        m_Entries.insert(position, VkSpecializationMapEntry {
+            .constantID = id,
+            .offset = static_cast<u32>(m_Data.size()),
+            .size = size
+        });
+
+        const u8* bytes = static_cast<const u8*>(data);
+        m_Data.insert(m_Data.end(), bytes, bytes + size);
+
+        return *this;
+    }
+
+    VkSpecializationInfo VulkanSpecializationConstants::GetInfo() const
+    {
+        return VkSpecializationInfo {
+            .mapEntryCount = static_cast<u32>(m_Entries.size()),
+            .pMapEntries = m_Entries.data(),
+            .dataSize = m_Data.size(),
+            .pData = m_Data.data()
+        };
+    }
+
+    void VulkanSpecializationConstants::AppendKey(std::vector<u64>& key) const
+    {
+        key.push_back(m_Entries.size());
+        for (const auto& entry : m_Entries) {
+            u64 value = 0;
+            std::memcpy(&value, m_Data.data() + entry.offset, std::min<usize>(entry.size, sizeof(value)));
+            key.push_back(entry.constantID);
+            key.push_back(value);
+        }
+    }
+
+    bool VulkanSpecializationConstants::operator==(const VulkanSpecializationConstants& other) const
+    {
+        if (m_Entries.size() != other.m_Entries.size())
+            return false;
+
+        for (usize i = 0; i < m_Entries.size(); ++i) {
+            const auto& a = m_Entries[i];
+            const auto& b = other.m_Entries[i];
+            if (a.constantID != b.constantID || a.size != b.size)
+                return false;
+
+            if (std::memcmp(m_Data.data() + a.offset, other.m_Data.data() + b.offset, a.size) != 0)
+                return false;
+        }
+
+        return true;
+    }
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <concepts>
+#include <type_traits>
+#include <vector>
+
+#include "VulkanTypes.hpp"
+
+namespace Renderer {
+
+    class VulkanSpecializationConstants
+    {
+    public:
+        template <typename T>
+        VulkanSpecializationConstants& Set(u32 id, const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T> && (sizeof(T) == 4 || sizeof(T) == 8 || std::same_as<T, bool>));
+
+            // SPIR-V booleans are consumed as 32-bit VkBool32 values.
+            if constexpr (std::same_as<T, bool>) {
+                VkBool32 converted = value ? VK_TRUE : VK_FALSE;
+                return SetBytes(id, &converted, sizeof(converted));
+            } else {
+                return SetBytes(id, &value, sizeof(T));
+            }
+        }
+
+        VulkanSpecializationConstants& SetBytes(u32 id, const void* data, usize size);
+
+        inline bool IsEmpty() const { return m_Entries.empty(); }
+        inline const std::vector<VkSpecializationMapEntry>& GetEntries() const { return m_Entries; }
+        inline const std::vector<u8>& GetData() const { return m_Data; }
+
+        VkSpecializationInfo GetInfo() const;
+        void AppendKey(std::vector<u64>& key) const;
+
+        bool operator==(const VulkanSpecializationConstants& other) const;
+
+    private:
+        std::vector<VkSpecializationMapEntry> m_Entries;
+        std::vector<u8> m_Data;
+    };
+
+}
@@ -12,33 +12,46 @@ namespace Renderer {
 
     VulkanSwapchain::~VulkanSwapchain()
     {
-        CleanupSwapchainResources();
-
-        if (m_Swapchain != VK_NULL_HANDLE)
-            vkDestroySwapchainKHR(m_Context->GetDevice(), m_Swapchain, nullptr);
+        // The device is idle by now, so present fences are not consulted.
+        for (auto& retired : m_Retired)
+            DestroyRetired(retired);
+
+        RetiredSwapchain current {
+            .swapchain = m_Swapchain,
+            .imageViews = std::move(m_ImageViews),
+            .presentFences = {}
+        };
+        DestroyRetired(current);
     }
 
-    bool VulkanSwapchain::AcquireNextImage(VkSemaphore& signalSemaphore, u64 timeout)
+    VulkanSwapchain::Status VulkanSwapchain::AcquireNextImage(VkSemaphore& signalSemaphore, u64 timeout)
     {
         if (m_Swapchain == VK_NULL_HANDLE) {
             LOG_ERROR("Swapchain not created")
-            return false;
+            return Status::Error;
         }
 
         VkResult result = vkAcquireNextImageKHR(m_Context->GetDevice(), m_Swapchain, timeout, signalSemaphore, VK_NULL_HANDLE, &m_CurrentImageIndex);
-        if (result != VK_SUCCESS) {
-            LOG_WARN("Failed to acquire swapchain image")
-            return false;
+        switch (result) {
+            case VK_SUCCESS:
+                m_ImageAcquired = true;
+                return Status::Success;
+            case VK_SUBOPTIMAL_KHR:
+                m_ImageAcquired = true;
+                return Status::Suboptimal;
+            case VK_ERROR_OUT_OF_DATE_KHR:
+                return Status::OutOfDate;
+            default:
+                LOG_WARN("Failed to acquire swapchain image ({})", static_cast<i32>(result))
+                return Status::Error;
         }
-
-        return true;
     }
 
-    bool VulkanSwapchain::Present(const VkQueue& presentQueue, const VkSemaphore& waitSemaphore, const VkFence& signalFence) const
+    VulkanSwapchain::Status VulkanSwapchain::Present(const VkQueue& presentQueue, const VkSemaphore& waitSemaphore, const VkFence& signalFence)
     {
         if (m_Swapchain == VK_NULL_HANDLE) {
             LOG_ERROR("Swapchain not created")
-            return false;
+            return Status::Error;
         }
 
         VkSwapchainPresentFenceInfoKHR presentFenceInfo {
@@ -48,9 +61,22 @@ namespace Renderer {
             .pFences = &signalFence
         };
 
+        u64 presentId = m_NextPresentId;
+
+        VkPresentIdKHR presentIdInfo {
+            .sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+            .pNext = m_Context->SupportsSwapchainMaintenance1() ? &presentFenceInfo : nullptr,
+            .swapchainCount = 1,
+            .pPresentIds = &presentId
+        };
+
+        const void* presentChain = presentIdInfo.pNext;
+        if (m_Context->SupportsPresentWait())
+            presentChain = &presentIdInfo;
+
         VkPresentInfoKHR presentInfo {
             .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-            .pNext = &presentFenceInfo,
+            .pNext = presentChain,
             .waitSemaphoreCount = 1,
             .pWaitSemaphores = &waitSemaphore,
             .swapchainCount = 1,
@@ -60,20 +86,93 @@ namespace Renderer {
         };
 
         VkResult result = vkQueuePresentKHR(presentQueue, &presentInfo);
-        if (result != VK_SUCCESS) {
-            LOG_WARN("Failed to present swapchain")
-            return false;
+        m_ImageAcquired = false;
+
+        if (m_Context->SupportsPresentWait()) {
+            m_LastPresentId = presentId;
+            m_NextPresentId++;
         }
 
-        return true;
+        // Without present fences the fence is left untouched; Recreate then
+        // falls back to idling the device instead of retiring.
+        if (m_Context->SupportsSwapchainMaintenance1() && std::find(m_PresentFences.begin(), m_PresentFences.end(), signalFence) == m_PresentFences.end())
+            m_PresentFences.push_back(signalFence);
+
+        switch (result) {
+            case VK_SUCCESS:
+                return Status::Success;
+            case VK_SUBOPTIMAL_KHR:
+                return Status::Suboptimal;
+            case VK_ERROR_OUT_OF_DATE_KHR:
+                return Status::OutOfDate;
+            default:
+                LOG_WARN("Failed to present swapchain ({})", static_cast<i32>(result))
+                return Status::Error;
+        }
     }
 
-    void VulkanSwapchain::Recreate(VkExtent2D extent)
+    bool VulkanSwapchain::WaitForPresent(u64 presentId, u64 timeout)
+    {
+        // Ids presented to a retired swapchain can no longer be waited on.
+        if (!m_Context->SupportsPresentWait() || presentId < m_FirstPresentId)
+            return true;
+
+        VkResult result = vkWaitForPresentKHR(m_Context->GetDevice(), m_Swapchain, presentId, timeout);
+        return result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR;
+    }
+
+    bool VulkanSwapchain::Recreate(VkExtent2D extent)
     {
         m_Config.extent = extent;
 
-        VkSwapchainKHR oldSwapchain = m_Swapchain;
-        CreateSwapchain(oldSwapchain);
+        VkSurfaceCapabilitiesKHR capabilities;
+        vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_Context->GetPhysicalDevice(), m_Context->GetSurface(), &capabilities);
+        if (capabilities.currentExtent.width == 0 || capabilities.currentExtent.height == 0)
+            return false;
+
+        ReleaseAcquiredImage();
+
+        // The old swapchain is retired rather than destroyed: it stays alive
+        // until the presents queued to it have completed, so recreation never
+        // has to wait for the GPU. Without present fences there is no signal
+        // for that, so the device is idled and the old swapchain destroyed.
+        bool retire = m_Context->SupportsSwapchainMaintenance1();
+        if (!retire)
+            vkDeviceWaitIdle(m_Context->GetDevice());
+
+        RetiredSwapchain retired {
+            .swapchain = m_Swapchain,
+            .imageViews = std::move(m_ImageViews),
+            .presentFences = std::move(m_PresentFences)
+        };
+
+        m_ImageViews.clear();
+        m_PresentFences.clear();
+
+        CreateSwapchain(retired.swapchain);
+        if (retire)
+            m_Retired.push_back(std::move(retired));
+        else
+            DestroyRetired(retired);
+        m_FirstPresentId = m_NextPresentId;
+
+        return true;
+    }
+
+    void VulkanSwapchain::CollectRetired()
+    {
+        // A present fence is only reset by its owner after it has been waited
+        // on, so an unsignaled fence belongs to a newer present and the check
+        // simply retries on a later frame.
+        std::erase_if(m_Retired, [this](RetiredSwapchain& retired) {
+            for (const auto& fence : retired.presentFences) {
+                if (vkGetFenceStatus(m_Context->GetDevice(), fence) != VK_SUCCESS)
+                    return false;
+            }
+
+            DestroyRetired(retired);
+            return true;
+        });
     }
 
     VulkanSwapchain::SupportDetails VulkanSwapchain::QueueSwapchainSupport(const VkPhysicalDevice& physicalDevice, const VkSurfaceKHR& surface) const
@@ -197,9 +296,6 @@ namespace Renderer {
         VkSwapchainKHR newSwapchain = VK_NULL_HANDLE;
         VK_CHECK(vkCreateSwapchainKHR(m_Context->GetDevice(), &createInfo, nullptr, &newSwapchain));
 
-        if (oldSwapchain != VK_NULL_HANDLE)
-            CleanupSwapchainResources();
-
         vkGetSwapchainImagesKHR(m_Context->GetDevice(), newSwapchain, &m_ImageCount, nullptr);
 
         m_Images.resize(m_ImageCount);
@@ -232,18 +328,43 @@ namespace Renderer {
             VK_CHECK(vkCreateImageView(m_Context->GetDevice(), &viewInfo, nullptr, &m_ImageViews.at(i)));
         }
 
-        if (oldSwapchain != VK_NULL_HANDLE)
-            vkDestroySwapchainKHR(m_Context->GetDevice(), oldSwapchain, nullptr);
+        m_Swapchain = newSwapchain;
+        m_CurrentImageIndex = 0;
+    }
+
+    void VulkanSwapchain::ReleaseAcquiredImage()
+    {
+        if (!m_ImageAcquired)
+            return;
+
+        m_ImageAcquired = false;
+
+        if (!m_Context->SupportsSwapchainMaintenance1())
+            return;
 
-        m_Swapchain = std::move(newSwapchain);
+        VkReleaseSwapchainImagesInfoEXT releaseInfo {
+            .sType = VK_STRUCTURE_TYPE_RELEASE_SWAPCHAIN_IMAGES_INFO_EXT,
+            .pNext = nullptr,
+            .swapchain = m_Swapchain,
+            .imageIndexCount = 1,
+            .pImageIndices = &m_CurrentImageIndex
+        };
+
+        VK_CHECK(vkReleaseSwapchainImagesEXT(m_Context->GetDevice(), &releaseInfo));
     }
 
-    void VulkanSwapchain::CleanupSwapchainResources()
+    void VulkanSwapchain::DestroyRetired(RetiredSwapchain& retired)
     {
-        for (auto& view : m_ImageViews) {
+        for (auto& view : retired.imageViews) {
             if (view != VK_NULL_HANDLE)
                 vkDestroyImageView(m_Context->GetDevice(), view, nullptr);
         }
+
+        if (retired.swapchain != VK_NULL_HANDLE)
+            vkDestroySwapchainKHR(m_Context->GetDevice(), retired.swapchain, nullptr);
+
+        retired.imageViews.clear();
+        retired.swapchain = VK_NULL_HANDLE;
     }
 
 }
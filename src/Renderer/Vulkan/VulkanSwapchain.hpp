@@ -10,13 +10,21 @@ namespace Renderer {
     class VulkanSwapchain
     {
     public:
+        enum class Status
+        {
+            Success,
+            Suboptimal,
+            OutOfDate,
+            Error
+        };
+
         struct Config
         {
             VkExtent2D extent { 0, 0 };
             VkFormat preferredFormat { VK_FORMAT_B8G8R8A8_SRGB };
             VkColorSpaceKHR preferredColorSpace { VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
             VkPresentModeKHR preferredPresentMode { VK_PRESENT_MODE_MAILBOX_KHR };
-            VkImageUsageFlags imageUsage { VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT };
+            VkImageUsageFlags imageUsage { VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT };
         };
 
     public:
@@ -39,10 +47,14 @@ namespace Renderer {
         inline const VkImage& GetCurrentImage() const { return m_Images[m_CurrentImageIndex]; }
         inline const VkImageView& GetCurrentImageView() const { return m_ImageViews[m_CurrentImageIndex]; }
 
-        bool AcquireNextImage(VkSemaphore& signalSemaphore, u64 timeout = std::numeric_limits<u64>::max());
-        bool Present(const VkQueue& presentQueue, const VkSemaphore& waitSemaphore, const VkFence& signalFence) const;
+        Status AcquireNextImage(VkSemaphore& signalSemaphore, u64 timeout = std::numeric_limits<u64>::max());
+        Status Present(const VkQueue& presentQueue, const VkSemaphore& waitSemaphore, const VkFence& signalFence);
 
-        void Recreate(VkExtent2D extent);
+        inline u64 GetLastPresentId() const { return m_LastPresentId; }
+        bool WaitForPresent(u64 presentId, u64 timeout);
+
+        bool Recreate(VkExtent2D extent);
+        void CollectRetired();
 
     private:
         struct SupportDetails
@@ -52,6 +64,13 @@ namespace Renderer {
             std::vector<VkPresentModeKHR> presentModes;
         };
 
+        struct RetiredSwapchain
+        {
+            VkSwapchainKHR swapchain { VK_NULL_HANDLE };
+            std::vector<VkImageView> imageViews;
+            std::vector<VkFence> presentFences;
+        };
+
     private:
         SupportDetails QueueSwapchainSupport(const VkPhysicalDevice& physicalDevice, const VkSurfaceKHR& surface) const;
         VkSurfaceFormatKHR ChooseSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& available) const;
@@ -59,7 +78,8 @@ namespace Renderer {
         VkExtent2D ChooseExtent(const VkSurfaceCapabilitiesKHR& caps, const VkExtent2D& desired) const;
 
         void CreateSwapchain(const VkSwapchainKHR& oldSwapchain = VK_NULL_HANDLE);
-        void CleanupSwapchainResources();
+        void ReleaseAcquiredImage();
+        void DestroyRetired(RetiredSwapchain& retired);
 
     private:
         Ref<VulkanContext> m_Context;
@@ -68,6 +88,14 @@ namespace Renderer {
         VkSwapchainKHR m_Swapchain { VK_NULL_HANDLE };
 
         u32 m_CurrentImageIndex { 0 };
+        bool m_ImageAcquired { false };
+
+        std::vector<VkFence> m_PresentFences;
+
+        u64 m_NextPresentId { 1 };
+        u64 m_LastPresentId { 0 };
+        u64 m_FirstPresentId { 1 };
+        std::vector<RetiredSwapchain> m_Retired;
 
         u32 m_ImageCount { 0 };
         std::vector<VkImage> m_Images;
@@ -0,0 +1,52 @@
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Core/Logger.hpp"
+#include "Core/MappedFile.hpp"
+#include "Core/ShaderArchive.hpp"
+
+int main(int argc, char** argv)
+{
+    Renderer::Logger::Init();
+
+    std::string output;
+    bool compress = false;
+    std::vector<Renderer::ShaderArchive::Source> sources;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--compress") {
+            compress = true;
+        } else if (arg == "-o" && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            Renderer::MappedFile file(arg);
+            if (!file.IsOpen()) {
+                std::fprintf(stderr, "Failed to read %s\n", arg.c_str());
+                return 1;
+            }
+
+            sources.push_back({
+                .name = std::filesystem::path(arg).filename().string(),
+                .data = std::vector<Renderer::u8>(file.GetData(), file.GetData() + file.GetSize())
+            });
+        }
+    }
+
+    if (output.empty()) {
+        std::fprintf(stderr, "Usage: ShaderPacker -o <archive> [--compress] <shader.spv>...\n");
+        return 1;
+    }
+
+    Renderer::usize count = sources.size();
+    if (!Renderer::ShaderArchive::Write(output, std::move(sources), compress)) {
+        std::fprintf(stderr, "Failed to write shader archive %s\n", output.c_str());
+        return 1;
+    }
+
+    std::printf("Packed %zu shaders into %s\n", count, output.c_str());
+    Renderer::Logger::Shutdown();
+    return 0;
+}